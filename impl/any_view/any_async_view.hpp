@@ -0,0 +1,603 @@
+#ifndef LIBCPP__RANGE_ANY_ASYNC_VIEW_HPP
+#define LIBCPP__RANGE_ANY_ASYNC_VIEW_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __has_include(<poll.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "any_view.hpp"
+#include "storage.hpp"
+
+namespace std::ranges {
+
+namespace __any_async_view {
+
+// the awaiter of an awaitable: its operator co_await, or itself
+template <class A>
+constexpr auto get_awaiter(A&& a) {
+  if constexpr (requires { std::forward<A>(a).operator co_await(); }) {
+    return std::forward<A>(a).operator co_await();
+  } else if constexpr (requires { operator co_await(std::forward<A>(a)); }) {
+    return operator co_await(std::forward<A>(a));
+  } else {
+    return remove_cvref_t<A>(std::forward<A>(a));
+  }
+}
+
+template <class A>
+using awaiter_t = decltype(get_awaiter(std::declval<A>()));
+
+template <class A>
+using await_result_t = decltype(std::declval<awaiter_t<A>&>().await_resume());
+
+template <class R>
+using iterator_t =
+    remove_cvref_t<await_result_t<decltype(std::declval<R&>().begin())>>;
+
+template <class R>
+using sentinel_t = decltype(std::declval<R&>().end());
+
+// begin() and ++it return awaitables, *it and it == end() are synchronous
+template <class R>
+concept async_range = requires(R& r) {
+  r.begin();
+  r.end();
+  requires requires(iterator_t<R>& it, const iterator_t<R>& cit) {
+    *cit;
+    ++it;
+    { cit == r.end() } -> std::convertible_to<bool>;
+  };
+};
+
+// await_suspend may return void, bool or a coroutine handle. The erased
+// one returns the coroutine to resume
+template <class Awaiter>
+std::coroutine_handle<> suspend(Awaiter& a, std::coroutine_handle<> h) {
+  using R = decltype(a.await_suspend(h));
+  if constexpr (std::is_void_v<R>) {
+    a.await_suspend(h);
+    return std::noop_coroutine();
+  } else if constexpr (std::same_as<R, bool>) {
+    if (a.await_suspend(h)) return std::noop_coroutine();
+    return h;
+  } else {
+    return a.await_suspend(h);
+  }
+}
+
+}  // namespace __any_async_view
+
+// An erased asynchronous range. begin() and ++it return awaitables, so that
+// a consumer coroutine suspends while the source waits for data instead of
+// blocking its thread:
+//   for (auto it = co_await v.begin(); it != v.end(); co_await ++it) {
+//     use(*it);
+//   }
+// The source is any type whose begin() and ++it are awaitable, and whose
+// iterator can be dereferenced and compared with end() synchronously. Like
+// any_view, the view, its iterator and the pending awaiter are each erased
+// in a detail::storage with the buffer sizes and allocator of Policy. An
+// asynchronous view is single pass: of the options, only input and copyable
+// apply
+template <class Element, any_view_options Opts = any_view_options::input,
+          class Ref = Element&, class Policy = any_view_policy>
+class any_async_view {
+  static_assert((Opts & any_view_options::category_mask) ==
+                    any_view_options::input,
+                "an asynchronous view is single pass");
+
+  static constexpr bool is_view_copyable =
+      __any_view::__flag_is_set(Opts, any_view_options::copyable);
+
+  using allocator_type = typename Policy::allocator_type;
+  using instrumentation = typename Policy::instrumentation;
+
+  // R is an asynchronous range whose elements convert to Ref, and it is
+  // copyable if the erased view is
+  template <class R>
+  static consteval bool range_constraint() {
+    if constexpr (__any_async_view::async_range<R>) {
+      return std::move_constructible<R> &&
+             (!is_view_copyable || std::copyable<R>) &&
+             std::convertible_to<
+                 decltype(*std::declval<
+                          const __any_async_view::iterator_t<R>&>()),
+                 Ref>;
+    } else {
+      return false;
+    }
+  }
+
+ public:
+  class iterator;
+
+ private:
+  struct awaiter_vtable_gen;
+  struct iterator_vtable_gen;
+  struct view_vtable_gen;
+
+  using awaiter_storage =
+      detail::storage<Policy::iterator_buffer_size + sizeof(void*),
+                      Policy::buffer_alignment, false, awaiter_vtable_gen,
+                      allocator_type, instrumentation>;
+
+  using iterator_storage =
+      detail::storage<Policy::iterator_buffer_size, Policy::buffer_alignment,
+                      false, iterator_vtable_gen, allocator_type,
+                      instrumentation>;
+
+  using view_storage =
+      detail::storage<Policy::view_buffer_size, Policy::buffer_alignment,
+                      is_view_copyable, view_vtable_gen, allocator_type,
+                      instrumentation>;
+
+  // State is one of the states below. Its resume() is the await_resume of
+  // the source's awaiter, and stores the result in the iterator
+  struct awaiter_vtable_gen {
+    struct vtable {
+      bool (*await_ready_)(awaiter_storage&);
+      std::coroutine_handle<> (*await_suspend_)(awaiter_storage&,
+                                                std::coroutine_handle<>);
+      void (*await_resume_)(awaiter_storage&, iterator&);
+    };
+
+    template <class State>
+    static constexpr vtable generate() {
+      vtable t;
+      t.await_ready_ = [](awaiter_storage& s) -> bool {
+        return s.template get_ptr<State>()->awaiter_.await_ready();
+      };
+      t.await_suspend_ = [](awaiter_storage& s, std::coroutine_handle<> h) {
+        auto& awaiter = s.template get_ptr<State>()->awaiter_;
+        return __any_async_view::suspend(awaiter, h);
+      };
+      t.await_resume_ = [](awaiter_storage& s, iterator& out) {
+        State::resume(s, out);
+      };
+      return t;
+    }
+  };
+
+  // the iterator carries the sentinel, so that the end test is one
+  // indirect call
+  template <class Iter, class Sent>
+  struct cursor_state {
+    cursor_state(Iter iter, Sent sent)
+        : iter_(std::move(iter)), sent_(std::move(sent)) {}
+
+    Iter iter_;
+    Sent sent_;
+  };
+
+  template <class Awaiter, class R>
+  struct begin_state {
+    begin_state(Awaiter awaiter, R* view)
+        : awaiter_(std::move(awaiter)), view_(view) {}
+
+    static void resume(awaiter_storage& s, iterator& out) {
+      auto& self = *s.template get_ptr<begin_state>();
+      using State = cursor_state<__any_async_view::iterator_t<R>,
+                                 __any_async_view::sentinel_t<R>>;
+      out.iter_ = iterator_storage(std::allocator_arg, s.get_allocator(),
+                                   detail::type<State>{},
+                                   self.awaiter_.await_resume(),
+                                   self.view_->end());
+    }
+
+    Awaiter awaiter_;
+    R* view_;
+  };
+
+  template <class Awaiter>
+  struct increment_state {
+    explicit increment_state(Awaiter awaiter)
+        : awaiter_(std::move(awaiter)) {}
+
+    static void resume(awaiter_storage& s, iterator&) {
+      s.template get_ptr<increment_state>()->awaiter_.await_resume();
+    }
+
+    Awaiter awaiter_;
+  };
+
+  struct iterator_vtable_gen {
+    struct vtable {
+      Ref (*deref_)(const iterator_storage&);
+      bool (*at_end_)(const iterator_storage&);
+      awaiter_storage (*increment_)(iterator_storage&);
+    };
+
+    template <class State>
+    static constexpr vtable generate() {
+      vtable t;
+      t.deref_ = [](const iterator_storage& s) -> Ref {
+        return *(s.template get_ptr<State>()->iter_);
+      };
+      t.at_end_ = [](const iterator_storage& s) -> bool {
+        auto& state = *s.template get_ptr<State>();
+        return state.iter_ == state.sent_;
+      };
+      t.increment_ = [](iterator_storage& s) {
+        auto& state = *s.template get_ptr<State>();
+        using Awaiter = __any_async_view::awaiter_t<decltype(++state.iter_)>;
+        return awaiter_storage(
+            std::allocator_arg, s.get_allocator(),
+            detail::type<increment_state<Awaiter>>{},
+            __any_async_view::get_awaiter(++state.iter_));
+      };
+      return t;
+    }
+  };
+
+  struct view_vtable_gen {
+    struct vtable {
+      awaiter_storage (*begin_)(view_storage&);
+    };
+
+    template <class R>
+    static constexpr vtable generate() {
+      vtable t;
+      t.begin_ = [](view_storage& s) {
+        R& r = *s.template get_ptr<R>();
+        using Awaiter = __any_async_view::awaiter_t<decltype(r.begin())>;
+        return awaiter_storage(std::allocator_arg, s.get_allocator(),
+                               detail::type<begin_state<Awaiter, R>>{},
+                               __any_async_view::get_awaiter(r.begin()), &r);
+      };
+      return t;
+    }
+  };
+
+ public:
+  // co_await v.begin() is the first iterator
+  class begin_awaiter {
+   public:
+    bool await_ready() {
+      return (*(awaiter_.get_vtable()->await_ready_))(awaiter_);
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) {
+      return (*(awaiter_.get_vtable()->await_suspend_))(awaiter_, h);
+    }
+
+    iterator await_resume() {
+      iterator it;
+      (*(awaiter_.get_vtable()->await_resume_))(awaiter_, it);
+      return it;
+    }
+
+    // private:
+    awaiter_storage awaiter_;
+  };
+
+  // co_await ++it advances it
+  class increment_awaiter {
+   public:
+    bool await_ready() {
+      return (*(awaiter_.get_vtable()->await_ready_))(awaiter_);
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) {
+      return (*(awaiter_.get_vtable()->await_suspend_))(awaiter_, h);
+    }
+
+    iterator& await_resume() {
+      (*(awaiter_.get_vtable()->await_resume_))(awaiter_, *iterator_);
+      return *iterator_;
+    }
+
+    // private:
+    awaiter_storage awaiter_;
+    iterator* iterator_;
+  };
+
+  class iterator {
+   public:
+    using value_type = remove_cv_t<Element>;
+    using difference_type = ptrdiff_t;
+
+    iterator() = default;
+    iterator(iterator&&) = default;
+    iterator& operator=(iterator&&) = default;
+
+    Ref operator*() const {
+      assert(!iter_.is_singular());
+      return (*(iter_.get_vtable()->deref_))(iter_);
+    }
+
+    increment_awaiter operator++() {
+      assert(!iter_.is_singular());
+      return increment_awaiter{(*(iter_.get_vtable()->increment_))(iter_),
+                               this};
+    }
+
+    friend bool operator==(const iterator& it, default_sentinel_t) {
+      return it.iter_.is_singular() ||
+             (*(it.iter_.get_vtable()->at_end_))(it.iter_);
+    }
+
+    // private:
+    iterator_storage iter_;
+  };
+
+  any_async_view() = default;
+
+  template <class R>
+    requires(!std::same_as<remove_cvref_t<R>, any_async_view>) &&
+            (range_constraint<remove_cvref_t<R>>())
+  any_async_view(R&& r)
+      : any_async_view(std::allocator_arg, allocator_type(),
+                       std::forward<R>(r)) {}
+
+  template <class R>
+    requires(!std::same_as<remove_cvref_t<R>, any_async_view>) &&
+            (range_constraint<remove_cvref_t<R>>())
+  any_async_view(std::allocator_arg_t, const allocator_type& alloc, R&& r)
+      : view_(std::allocator_arg, alloc, detail::type<remove_cvref_t<R>>{},
+              std::forward<R>(r)) {}
+
+  // The iterators and the pending awaiters refer to the view
+  begin_awaiter begin() {
+    assert(!view_.is_singular());
+    return begin_awaiter{(*(view_.get_vtable()->begin_))(view_)};
+  }
+
+  default_sentinel_t end() const noexcept { return default_sentinel; }
+
+  allocator_type get_allocator() const noexcept {
+    return view_.get_allocator();
+  }
+
+ private:
+  view_storage view_;
+};
+
+#if __has_include(<poll.h>) && __has_include(<unistd.h>)
+
+// The contents of a file descriptor, as an asynchronous range of chunks of
+// up to chunk_size bytes. If the descriptor has data, a chunk is read
+// without suspending. Otherwise the consumer is resumed when the chunk is
+// there, on a thread that waits for the descriptors of all the fd_chunks.
+// Destroying the fd_chunks cancels a pending read: its consumer is not
+// resumed. The descriptor is not closed. The buffer and the read state live
+// on the heap, so the iterators and a pending read follow a moved fd_chunks
+class fd_chunks {
+  class reactor;
+  struct state;
+
+ public:
+  class iterator;
+
+  class read_awaiter {
+   public:
+    bool await_ready() {
+      pollfd p{state_->fd_, POLLIN, 0};
+      if (::poll(&p, 1, 0) <= 0) return false;
+      state_->read_chunk();
+      return true;
+    }
+
+    void await_suspend(std::coroutine_handle<> h);
+
+    iterator await_resume() {
+      if (state_->error_) {
+        throw std::system_error(state_->error_, std::generic_category());
+      }
+      return iterator(state_);
+    }
+
+    // private:
+    state* state_;
+  };
+
+  class iterator {
+   public:
+    std::span<const std::byte> operator*() const {
+      return {state_->buf_.data(), state_->size_};
+    }
+
+    read_awaiter operator++() { return read_awaiter{state_}; }
+
+    friend bool operator==(const iterator& it, default_sentinel_t) {
+      return it.at_end();
+    }
+
+    // private:
+    state* state_;
+
+    explicit iterator(state* s) : state_(s) {}
+
+    bool at_end() const { return state_->size_ == 0; }
+  };
+
+  explicit fd_chunks(int fd, size_t chunk_size = 64 * 1024)
+      : state_(std::make_unique<state>(fd, chunk_size)) {}
+
+  fd_chunks(fd_chunks&&) noexcept = default;
+
+  ~fd_chunks();
+
+  read_awaiter begin() { return read_awaiter{state_.get()}; }
+
+  default_sentinel_t end() const noexcept { return default_sentinel; }
+
+ private:
+  struct state {
+    state(int fd, size_t chunk_size) : fd_(fd), buf_(chunk_size) {}
+
+    void read_chunk() {
+      ssize_t n;
+      do {
+        n = ::read(fd_, buf_.data(), buf_.size());
+      } while (n < 0 && errno == EINTR);
+      error_ = n < 0 ? errno : 0;
+      size_ = n < 0 ? 0 : size_t(n);
+    }
+
+    int fd_;
+    std::vector<std::byte> buf_;
+    size_t size_ = 0;
+    int error_ = 0;
+    // the reactor has a read of it pending or is resuming its consumer.
+    // Only the reactor clears it
+    std::atomic<bool> suspended_ = false;
+  };
+
+  std::unique_ptr<state> state_;
+};
+
+// One thread for the whole program polls the descriptors of the pending
+// reads, reads the chunks and resumes the consumers. A pipe wakes it up when
+// a read is added or when the program exits
+class fd_chunks::reactor {
+ public:
+  static reactor& get() {
+    static reactor r;
+    return r;
+  }
+
+  void add(state* s, std::coroutine_handle<> h) {
+    {
+      std::lock_guard lock(mutex_);
+      s->suspended_ = true;
+      pending_.push_back({s, h, next_id_++});
+    }
+    wake();
+  }
+
+  // s is neither read nor resumed once this returns. Called from another
+  // thread, it first waits for a consumer of s that is running, as that
+  // consumer can add another read of s
+  void cancel(state* s) {
+    std::unique_lock lock(mutex_);
+    if (std::this_thread::get_id() != thread_.get_id()) {
+      resumed_.wait(lock, [&] { return resuming_ != s; });
+    }
+    std::erase_if(pending_, [&](const read& r) { return r.state_ == s; });
+    // destroyed by its own consumer: complete() no longer refers to it
+    if (resuming_ == s) resuming_ = nullptr;
+    s->suspended_ = false;
+  }
+
+ private:
+  struct read {
+    state* state_;
+    std::coroutine_handle<> h_;
+    uint64_t id_;
+  };
+
+  reactor() {
+    if (::pipe(wake_) != 0) {
+      throw std::system_error(errno, std::generic_category());
+    }
+    ::fcntl(wake_[1], F_SETFL, ::fcntl(wake_[1], F_GETFL) | O_NONBLOCK);
+    thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+  }
+
+  ~reactor() {
+    thread_.request_stop();
+    wake();
+    thread_.join();
+    ::close(wake_[0]);
+    ::close(wake_[1]);
+  }
+
+  // a full pipe wakes the thread up as well
+  void wake() {
+    char c = 0;
+    [[maybe_unused]] auto n = ::write(wake_[1], &c, 1);
+  }
+
+  void run(std::stop_token stop) {
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    while (!stop.stop_requested()) {
+      fds.assign(1, pollfd{wake_[0], POLLIN, 0});
+      ids.assign(1, 0);
+      {
+        std::lock_guard lock(mutex_);
+        for (const read& r : pending_) {
+          fds.push_back(pollfd{r.state_->fd_, POLLIN, 0});
+          ids.push_back(r.id_);
+        }
+      }
+      if (::poll(fds.data(), fds.size(), -1) < 0) continue;
+      if (fds[0].revents != 0) {
+        char buf[64];
+        [[maybe_unused]] auto n = ::read(wake_[0], buf, sizeof(buf));
+      }
+      for (size_t i = 1; i != fds.size(); ++i) {
+        if (fds[i].revents != 0) complete(ids[i]);
+      }
+    }
+  }
+
+  // reads the chunk of a read that is not cancelled, and resumes its
+  // consumer. The state stays suspended while the consumer runs, so that
+  // a destructor on another thread waits for it, and is released after
+  // unless the consumer added another read or destroyed it
+  void complete(uint64_t id) {
+    std::coroutine_handle<> h;
+    {
+      std::lock_guard lock(mutex_);
+      auto it = std::ranges::find(pending_, id, &read::id_);
+      if (it == pending_.end()) return;
+      it->state_->read_chunk();
+      h = it->h_;
+      resuming_ = it->state_;
+      pending_.erase(it);
+    }
+    h.resume();
+    {
+      std::lock_guard lock(mutex_);
+      if (resuming_ &&
+          std::ranges::find(pending_, resuming_, &read::state_) ==
+              pending_.end()) {
+        resuming_->suspended_ = false;
+      }
+      resuming_ = nullptr;
+    }
+    resumed_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable resumed_;
+  std::vector<read> pending_;
+  uint64_t next_id_ = 1;
+  state* resuming_ = nullptr;
+  int wake_[2];
+  std::jthread thread_;
+};
+
+inline void fd_chunks::read_awaiter::await_suspend(std::coroutine_handle<> h) {
+  reactor::get().add(state_, h);
+}
+
+inline fd_chunks::~fd_chunks() {
+  if (state_ && state_->suspended_) reactor::get().cancel(state_.get());
+}
+
+#endif
+
+}  // namespace std::ranges
+
+#endif
@@ -0,0 +1,352 @@
+#ifndef LIBCPP__RANGE_ANY_OUTPUT_RANGE_HPP
+#define LIBCPP__RANGE_ANY_OUTPUT_RANGE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#include "any_view.hpp"
+#include "storage.hpp"
+
+namespace std::ranges {
+
+namespace __any_output_range {
+
+// A sink of T is a container of values constructible from T, or any type
+// with push(T). Containers take the values with emplace_back or insert, and
+// batches with append_range or insert. A sink can also have
+// push_batch(std::span<const T>) and reserve(n), where n is the number of
+// values about to be pushed. Values that can be copied are also pushed by
+// copy
+template <class S, class T>
+concept container_of =
+    std::ranges::range<S> &&
+    std::constructible_from<std::ranges::range_value_t<S>, T> &&
+    (!copy_constructible<T> ||
+     std::constructible_from<std::ranges::range_value_t<S>, const T&>) &&
+    (requires(S& s, T&& t) { s.emplace_back(std::move(t)); } ||
+     requires(S& s, T&& t) { s.insert(s.end(), std::move(t)); });
+
+template <class S, class T>
+concept sink = container_of<S, T> ||
+               (requires(S& s, T&& t) { s.push(std::move(t)); } &&
+                (!copy_constructible<T> ||
+                 requires(S& s, const T& t) { s.push(t); }));
+
+template <class S, class V>
+constexpr void push(S& s, V&& v) {
+  if constexpr (requires { s.push(std::forward<V>(v)); }) {
+    s.push(std::forward<V>(v));
+  } else if constexpr (requires { s.emplace_back(std::forward<V>(v)); }) {
+    s.emplace_back(std::forward<V>(v));
+  } else {
+    s.insert(s.end(), std::forward<V>(v));
+  }
+}
+
+template <class S, class T>
+constexpr void push_batch(S& s, std::span<const T> values) {
+  if constexpr (requires { s.push_batch(values); }) {
+    s.push_batch(values);
+  } else if constexpr (requires { s.append_range(values); }) {
+    s.append_range(values);
+  } else if constexpr (requires {
+                         s.insert(s.end(), values.begin(), values.end());
+                       }) {
+    // a memmove into a vector of trivially copyable values
+    s.insert(s.end(), values.begin(), values.end());
+  } else {
+    for (const T& v : values) {
+      __any_output_range::push(s, v);
+    }
+  }
+}
+
+// A container grows by at least a factor of 2, so that many small
+// reservations do not make the pushes quadratic
+template <class S>
+constexpr void reserve(S& s, size_t n) {
+  if constexpr (requires {
+                  s.capacity();
+                  s.size();
+                  s.reserve(n);
+                }) {
+    if (s.capacity() - s.size() < n) {
+      s.reserve(std::max(s.size() + n, 2 * s.size()));
+    }
+  } else if constexpr (requires { s.reserve(n); }) {
+    s.reserve(n);
+  }
+}
+
+// an lvalue sink is referred to, an rvalue sink is owned
+template <class S>
+struct ref {
+  S* s_;
+  constexpr S& get() { return *s_; }
+};
+
+template <class S>
+struct owned {
+  S s_;
+  constexpr S& get() { return s_; }
+};
+
+template <class S>
+using holder_t =
+    conditional_t<is_lvalue_reference_v<S>, ref<remove_reference_t<S>>,
+                  owned<remove_cvref_t<S>>>;
+
+}  // namespace __any_output_range
+
+// An erased sink of values, the counterpart of any_view for the functions
+// that produce results:
+//   void getWidgetNames(any_output_range<std::string> out);
+//   std::vector<std::string> names;
+//   getWidgetNames(names);
+// A container or a user type with push(T), such as a ring buffer or a file
+// writer, is referred to if it is an lvalue and owned otherwise, in a
+// detail::storage with the buffer sizes and allocator of Policy. Each push
+// is one indirect call, and push_batch writes a whole span with one
+// indirect call, e.g. into vector::append_range. It is also an output range,
+// so that the std algorithms can write to it:
+//   std::ranges::copy(values, out.begin());
+template <class T, class Policy = any_view_policy>
+  requires std::is_object_v<T> && std::same_as<T, remove_cv_t<T>>
+class any_output_range {
+  using allocator_type = typename Policy::allocator_type;
+  using instrumentation = typename Policy::instrumentation;
+
+  struct sink_vtable_gen;
+
+  using sink_storage =
+      detail::storage<Policy::view_buffer_size, Policy::buffer_alignment,
+                      false, sink_vtable_gen, allocator_type,
+                      instrumentation>;
+
+  struct sink_vtable_gen {
+    struct vtable {
+      void (*push_move_)(sink_storage&, T&&);
+      void (*push_copy_)(sink_storage&, const T&) = nullptr;
+      void (*push_batch_)(sink_storage&, std::span<const T>) = nullptr;
+      void (*reserve_)(sink_storage&, size_t);
+    };
+
+    template <class Holder>
+    static constexpr vtable generate() {
+      vtable t;
+      t.push_move_ = [](sink_storage& s, T&& v) {
+        __any_output_range::push(s.template get_ptr<Holder>()->get(),
+                                 std::move(v));
+      };
+      if constexpr (copy_constructible<T>) {
+        t.push_copy_ = [](sink_storage& s, const T& v) {
+          __any_output_range::push(s.template get_ptr<Holder>()->get(), v);
+        };
+        t.push_batch_ = [](sink_storage& s, std::span<const T> values) {
+          __any_output_range::push_batch(s.template get_ptr<Holder>()->get(),
+                                         values);
+        };
+      }
+      t.reserve_ = [](sink_storage& s, size_t n) {
+        __any_output_range::reserve(s.template get_ptr<Holder>()->get(), n);
+      };
+      return t;
+    }
+  };
+
+ public:
+  // *it = v pushes v
+  class iterator {
+   public:
+    using difference_type = ptrdiff_t;
+
+    constexpr iterator() = default;
+
+    constexpr iterator& operator*() { return *this; }
+    constexpr iterator& operator++() { return *this; }
+    constexpr iterator& operator++(int) { return *this; }
+
+    constexpr iterator& operator=(const T& v)
+      requires copy_constructible<T>
+    {
+      parent_->push(v);
+      return *this;
+    }
+
+    constexpr iterator& operator=(T&& v) {
+      parent_->push(std::move(v));
+      return *this;
+    }
+
+    // private:
+    any_output_range* parent_ = nullptr;
+
+    constexpr explicit iterator(any_output_range* parent) : parent_(parent) {}
+  };
+
+  constexpr any_output_range() = default;
+
+  template <class S>
+    requires(!std::same_as<remove_cvref_t<S>, any_output_range>) &&
+            __any_output_range::sink<remove_reference_t<S>, T>
+  constexpr any_output_range(S&& s)
+      : any_output_range(std::allocator_arg, allocator_type(),
+                         std::forward<S>(s)) {}
+
+  template <class S>
+    requires(!std::same_as<remove_cvref_t<S>, any_output_range>) &&
+            __any_output_range::sink<remove_reference_t<S>, T>
+  constexpr any_output_range(std::allocator_arg_t, const allocator_type& alloc,
+                             S&& s)
+      : sink_(std::allocator_arg, alloc,
+              detail::type<__any_output_range::holder_t<S>>{},
+              make_holder(std::forward<S>(s))) {}
+
+  constexpr void push(const T& v)
+    requires copy_constructible<T>
+  {
+    assert(!sink_.is_singular());
+    (*(sink_.get_vtable()->push_copy_))(sink_, v);
+  }
+
+  constexpr void push(T&& v) {
+    assert(!sink_.is_singular());
+    (*(sink_.get_vtable()->push_move_))(sink_, std::move(v));
+  }
+
+  constexpr void push_batch(std::span<const T> values)
+    requires copy_constructible<T>
+  {
+    assert(!sink_.is_singular());
+    (*(sink_.get_vtable()->push_batch_))(sink_, values);
+  }
+
+  // about n values are going to be pushed
+  constexpr void reserve(size_t n) {
+    assert(!sink_.is_singular());
+    (*(sink_.get_vtable()->reserve_))(sink_, n);
+  }
+
+  // The iterators refer to the any_output_range
+  constexpr iterator begin() { return iterator(this); }
+  constexpr unreachable_sentinel_t end() const noexcept {
+    return unreachable_sentinel;
+  }
+
+  constexpr allocator_type get_allocator() const noexcept {
+    return sink_.get_allocator();
+  }
+
+ private:
+  template <class S>
+  static constexpr __any_output_range::holder_t<S> make_holder(S&& s) {
+    if constexpr (is_lvalue_reference_v<S>) {
+      return {std::addressof(s)};
+    } else {
+      return {std::move(s)};
+    }
+  }
+
+  sink_storage sink_;
+};
+
+#if __has_include(<unistd.h>)
+
+// A sink that writes the bytes of trivially copyable values to a file
+// descriptor. The values are gathered in a buffer of buffer_size bytes,
+// which is written when it is full, by flush() and by the destructor. A
+// batch larger than the buffer is written without being copied. The
+// destructor cannot report a failed write: call flush() before it to see
+// the error. The descriptor is not closed
+template <class T>
+  requires std::is_trivially_copyable_v<T>
+class fd_writer {
+ public:
+  explicit fd_writer(int fd, size_t buffer_size = 64 * 1024) : fd_(fd) {
+    buf_.reserve(std::max(buffer_size, sizeof(T)));
+  }
+
+  fd_writer(fd_writer&&) = default;
+
+  // the values pushed to *this are written first
+  fd_writer& operator=(fd_writer&& other) {
+    if (this != &other) {
+      flush();
+      fd_ = other.fd_;
+      buf_ = std::move(other.buf_);
+    }
+    return *this;
+  }
+
+  ~fd_writer() {
+    try {
+      flush();
+    } catch (const std::system_error&) {
+    }
+  }
+
+  void push(const T& v) { push_batch(std::span<const T>(&v, 1)); }
+
+  void push_batch(std::span<const T> values) {
+    auto bytes = std::as_bytes(values);
+    if (buf_.size() + bytes.size() > buf_.capacity()) {
+      flush();
+      if (bytes.size() > buf_.capacity()) {
+        if (int error = write(bytes).second) {
+          throw std::system_error(error, std::generic_category());
+        }
+        return;
+      }
+    }
+    buf_.insert(buf_.end(), bytes.begin(), bytes.end());
+  }
+
+  // throws std::system_error if the write fails. The bytes that were
+  // written before are dropped from the buffer, so that the next flush()
+  // writes the rest
+  void flush() {
+    auto [written, error] = write(buf_);
+    buf_.erase(buf_.begin(), buf_.begin() + ptrdiff_t(written));
+    if (error != 0) {
+      throw std::system_error(error, std::generic_category());
+    }
+  }
+
+ private:
+  // the number of bytes written, and errno if they are not all written
+  std::pair<size_t, int> write(std::span<const std::byte> bytes) {
+    size_t written = 0;
+    while (written != bytes.size()) {
+      ssize_t n =
+          ::write(fd_, bytes.data() + written, bytes.size() - written);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        return {written, errno};
+      }
+      written += size_t(n);
+    }
+    return {written, 0};
+  }
+
+  int fd_;
+  std::vector<std::byte> buf_;
+};
+
+#endif
+
+}  // namespace std::ranges
+
+#endif
@@ -1,12 +1,21 @@
 #ifndef LIBCPP__RANGE_ANY_VIEW_TE_HPP
 #define LIBCPP__RANGE_ANY_VIEW_TE_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <type_traits>
+#include <vector>
 
+#include "contiguous_algorithm.hpp"
+#include "instrumentation.hpp"
 #include "reserve_hint.hpp"
 #include "storage.hpp"
 #include "type_traits.hpp"
@@ -26,7 +35,12 @@ enum class any_view_options {
   approximately_sized = 32,
   sized = 96,
   borrowed = 128,
-  copyable = 256
+  copyable = 256,
+  indexed = 512,
+  sized_sentinel = 1024,
+  counted = 2048,
+  const_iterable = 4096,
+  common = 8192
 };
 
 constexpr any_view_options operator&(any_view_options lhs,
@@ -69,154 +83,552 @@ struct __rvalue_ref<T&> {
 template <class T>
 using __rvalue_ref_t = typename __rvalue_ref<T>::type;
 
-template <class Element, any_view_options Opts = any_view_options::input,
-          class Ref = Element&, class RValueRef = __rvalue_ref_t<Ref>,
-          class Diff = ptrdiff_t>
-class any_view
-    : public view_interface<any_view<Element, Opts, Ref, RValueRef, Diff>> {
- public:
-  struct any_iterator;
-  struct any_sentinel;
+// Storage policy of any_view. To change a setting, derive from it and
+// hide the member, e.g.
+//   struct big_iterators : any_view_policy {
+//     static constexpr size_t iterator_buffer_size = 8 * sizeof(void*);
+//   };
+// Objects that do not fit in (or are over-aligned for) the small buffers
+// are allocated with `allocator_type`. The iterators, sentinels and cursors
+// use the allocator of the view they come from. `instrumentation` is told
+// about the erased calls, see any_view_instrumentation.hpp
+struct any_view_policy {
+  // small buffer of the erased iterator and sentinel
+  static constexpr size_t iterator_buffer_size = 3 * sizeof(void*);
+  // small buffer of the erased view
+  static constexpr size_t view_buffer_size = 4 * sizeof(void*);
+  static constexpr size_t buffer_alignment = sizeof(void*);
+  using allocator_type = std::allocator<std::byte>;
+  using instrumentation = detail::no_instrumentation;
+};
 
-  static constexpr any_view_options Traversal =
-      Opts & any_view_options::category_mask;
-  static constexpr bool is_view_copyable =
-      (Opts & any_view_options::copyable) != any_view_options::none;
-  static constexpr bool is_iterator_copyable =
-      Traversal >= any_view_options::forward;
+namespace detail {
 
-  static constexpr bool is_sized =
-      (Opts & any_view_options::sized) == any_view_options::sized;
-  static constexpr bool is_approximately_sized =
-      (Opts & any_view_options::approximately_sized) ==
-      any_view_options::approximately_sized;
+// std::pmr::polymorphic_allocator is not assignable, but the erased objects
+// carry their allocator along when they are moved or swapped
+template <class T>
+struct resource_allocator {
+  using value_type = T;
 
-  template <class T, bool HasT>
-  struct maybe_t : T {};
+  resource_allocator() noexcept = default;
+  resource_allocator(std::pmr::memory_resource* r) noexcept : resource_(r) {}
+  template <class U>
+  resource_allocator(const resource_allocator<U>& other) noexcept
+      : resource_(other.resource()) {}
 
-  template <class T>
-  struct maybe_t<T, false> {};
+  T* allocate(size_t n) {
+    return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
 
-  using iterator_storage =
-      detail::storage<3 * sizeof(void*), sizeof(void*), is_iterator_copyable>;
+  void deallocate(T* p, size_t n) noexcept {
+    resource_->deallocate(p, n * sizeof(T), alignof(T));
+  }
 
-  struct input_iterator_vtable {
-    Ref (*deref_)(const iterator_storage&);
-    void (*increment_)(iterator_storage&);
-    RValueRef (*iter_move_)(const iterator_storage&);
-  };
+  std::pmr::memory_resource* resource() const noexcept { return resource_; }
 
-  struct equality_vtable {
-    bool (*equal_)(const iterator_storage&, const iterator_storage&);
-  };
+  template <class U>
+  friend bool operator==(const resource_allocator& x,
+                         const resource_allocator<U>& y) noexcept {
+    return *x.resource() == *y.resource();
+  }
 
-  struct forward_iterator_vtable : input_iterator_vtable, equality_vtable {};
+ private:
+  std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+};
 
-  struct bidirectional_iterator_vtable : forward_iterator_vtable {
-    void (*decrement_)(iterator_storage&);
-  };
+// The erased iterator and sentinel only depend on the types of the
+// operations and on the storage policy, not on the options of the any_view.
+// An any_view built from another any_view adopts its iterators instead of
+// erasing them a second time. The slots of the vtables are filled according
+// to the capabilities of the underlying iterator and sentinel
+template <class Ref, class RValueRef, class Diff, class Policy>
+struct erased_iterator {
+  using allocator_type = typename Policy::allocator_type;
+  using instrumentation = typename Policy::instrumentation;
+
+  struct vtable_gen;
+
+  // the iterator operations live in the same vtable as the copy, move and
+  // destroy operations of the storage
+  using storage_type =
+      storage<Policy::iterator_buffer_size, Policy::buffer_alignment, true,
+              vtable_gen, allocator_type, instrumentation>;
+
+  using sentinel_storage_type =
+      storage<Policy::iterator_buffer_size, Policy::buffer_alignment, true,
+              no_extension, allocator_type, instrumentation>;
+
+  // next_batch hands out pointers to the elements, or the elements
+  // themselves if Ref is a prvalue. Pointers are only handed out when the
+  // underlying iterator is a forward_iterator, because incrementing an input
+  // iterator may invalidate the previous references
+  using batch_element =
+      conditional_t<is_reference_v<Ref>, add_pointer_t<Ref>, Ref>;
 
-  struct random_access_iterator_vtable : bidirectional_iterator_vtable {
-    void (*advance_)(iterator_storage&, Diff);
-    Diff (*distance_to_)(const iterator_storage&, const iterator_storage&);
-  };
+  template <class Iter>
+  static constexpr bool is_batchable = is_reference_v<Ref>
+                                           ? std::forward_iterator<Iter>
+                                           : std::assignable_from<Ref&, Ref>;
+
+  struct empty_iterator {};
+  struct empty_sentinel {};
+
+  // Empty sentinels, such as default_sentinel_t and unreachable_sentinel_t,
+  // are not stored: a value-initialized one is used instead
+  template <class Sent>
+  static constexpr bool is_stateless =
+      is_empty_v<Sent> && is_trivially_default_constructible_v<Sent> &&
+      is_trivially_copyable_v<Sent>;
+
+  template <class Sent>
+  static constexpr sentinel_storage_type make_sentinel(
+      const allocator_type& alloc, [[maybe_unused]] Sent sent) {
+    if constexpr (is_stateless<Sent>) {
+      return sentinel_storage_type();
+    } else {
+      return sentinel_storage_type(allocator_arg, alloc, type<Sent>{},
+                                   std::move(sent));
+    }
+  }
+
+  template <class Sent>
+  static constexpr bool has_sentinel(const sentinel_storage_type& sent) {
+    return is_stateless<Sent> || !sent.is_singular();
+  }
+
+  template <class Sent>
+  static constexpr decltype(auto) get_sentinel(
+      const sentinel_storage_type& sent) {
+    if constexpr (is_stateless<Sent>) {
+      return Sent{};
+    } else {
+      return *(sent.template get_ptr<Sent>());
+    }
+  }
 
-  struct contiguous_iterator_vtable : random_access_iterator_vtable {
-    std::add_pointer_t<Ref> (*arrow_)(const iterator_storage&);
+  // Hot entries first: deref, increment and equal are used on every step of
+  // a loop and share the first cache line, as the vtables are aligned to 64
+  // bytes. The rest, followed by the storage's copy/move/destroy entries,
+  // come after them
+  struct alignas(64) vtable {
+    Ref (*deref_)(const storage_type&);
+    void (*increment_)(storage_type&);
+    bool (*equal_)(const storage_type&, const storage_type&);
+    // iter == default_sentinel, null if Iter is not comparable with it
+    bool (*at_end_)(const storage_type&);
+    RValueRef (*iter_move_)(const storage_type&);
+    void (*decrement_)(storage_type&);
+    void (*advance_)(storage_type&, Diff);
+    Diff (*distance_to_)(const storage_type&, const storage_type&);
   };
 
-  using any_iterator_vtable = conditional_t<
-      Traversal == any_view_options::contiguous, contiguous_iterator_vtable,
-      conditional_t<
-          Traversal == any_view_options::random_access,
-          random_access_iterator_vtable,
-          conditional_t<
-              Traversal == any_view_options::bidirectional,
-              bidirectional_iterator_vtable,
-              conditional_t<Traversal == any_view_options::forward,
-                            forward_iterator_vtable, input_iterator_vtable>>>>;
-
-  struct iterator_vtable_gen {
+  struct vtable_gen {
+    using vtable = erased_iterator::vtable;
+
     template <class Iter>
-    static constexpr auto generate() {
-      any_iterator_vtable t;
+    static constexpr vtable generate() {
+      if constexpr (std::same_as<Iter, empty_iterator>) {
+        return generate_empty();
+      } else {
+        return generate_for<Iter>();
+      }
+    }
+
+    template <class Iter>
+    static constexpr vtable generate_for() {
+      vtable t{};
 
       t.deref_ = &deref<Iter>;
       t.increment_ = &increment<Iter>;
       t.iter_move_ = &iter_move<Iter>;
 
-      if constexpr (Traversal >= any_view_options::forward) {
+      if constexpr (std::forward_iterator<Iter>) {
         t.equal_ = &equal<Iter>;
       }
 
-      if constexpr (Traversal >= any_view_options::bidirectional) {
+      if constexpr (std::sentinel_for<default_sentinel_t, Iter>) {
+        t.at_end_ = &at_end<Iter>;
+      }
+
+      if constexpr (std::bidirectional_iterator<Iter>) {
         t.decrement_ = &decrement<Iter>;
       }
 
-      if constexpr (Traversal >= any_view_options::random_access) {
+      if constexpr (std::random_access_iterator<Iter>) {
         t.advance_ = &advance<Iter>;
         t.distance_to_ = &distance_to<Iter>;
       }
+      return t;
+    }
+
+    static consteval vtable generate_empty() {
+      vtable t;
+
+      t.deref_ = [](const storage_type&) -> Ref {
+        assert(false && "Dereferencing empty iterator");
+        std::unreachable();
+      };
+      t.increment_ = [](storage_type&) {
+        assert(false && "Incrementing empty iterator");
+      };
+      t.iter_move_ = [](const storage_type&) -> RValueRef {
+        assert(false && "iter_moving empty iterator");
+        std::unreachable();
+      };
+      t.equal_ = [](const storage_type&, const storage_type&) {
+        return true;
+      };
+      t.at_end_ = [](const storage_type&) { return true; };
+      t.decrement_ = [](storage_type&) {
+        assert(false && "Decrementing empty iterator");
+      };
+      t.advance_ = [](storage_type&, Diff) {
+        assert(false && "Advancing empty iterator");
+      };
+      t.distance_to_ = [](const storage_type&, const storage_type&) -> Diff {
+        assert(false && "Distance to empty iterator");
+        std::unreachable();
+      };
 
-      if constexpr (Traversal == any_view_options::contiguous) {
-        t.arrow_ = &arrow<Iter>;
-      }
       return t;
     }
 
     // input
 
     template <class Iter>
-    static constexpr Ref deref(const iterator_storage& self) {
+    static constexpr Ref deref(const storage_type& self) {
+      instrument<instrumentation, Iter>(any_view_event::deref);
       return **(self.template get_ptr<Iter>());
     };
 
     template <class Iter>
-    static constexpr void increment(iterator_storage& self) {
+    static constexpr void increment(storage_type& self) {
+      instrument<instrumentation, Iter>(any_view_event::increment);
       ++(*(self.template get_ptr<Iter>()));
     };
 
     template <class Iter>
-    static constexpr RValueRef iter_move(const iterator_storage& self) {
+    static constexpr RValueRef iter_move(const storage_type& self) {
+      instrument<instrumentation, Iter>(any_view_event::iter_move);
       return std::ranges::iter_move(*(self.template get_ptr<Iter>()));
     };
 
+    template <class Iter>
+    static constexpr bool at_end(const storage_type& self) {
+      instrument<instrumentation, Iter>(any_view_event::equal);
+      return *(self.template get_ptr<Iter>()) == default_sentinel;
+    }
+
     // forward
 
     template <class Iter>
-    static constexpr bool equal(const iterator_storage& lhs,
-                                const iterator_storage& rhs) {
+    static constexpr bool equal(const storage_type& lhs,
+                                const storage_type& rhs) {
+      instrument<instrumentation, Iter>(any_view_event::equal);
       return *lhs.template get_ptr<Iter>() == *rhs.template get_ptr<Iter>();
     }
 
     // bidi
 
     template <class Iter>
-    static constexpr void decrement(iterator_storage& self) {
+    static constexpr void decrement(storage_type& self) {
+      instrument<instrumentation, Iter>(any_view_event::decrement);
       --(*(self.template get_ptr<Iter>()));
     }
 
     // random access
 
     template <class Iter>
-    static constexpr void advance(iterator_storage& self, Diff diff) {
+    static constexpr void advance(storage_type& self, Diff diff) {
+      instrument<instrumentation, Iter>(any_view_event::advance);
       (*self.template get_ptr<Iter>()) += diff;
     }
 
     template <class Iter>
-    static constexpr Diff distance_to(const iterator_storage& self,
-                                      const iterator_storage& other) {
+    static constexpr Diff distance_to(const storage_type& self,
+                                      const storage_type& other) {
+      instrument<instrumentation, Iter>(any_view_event::distance_to);
       return Diff((*self.template get_ptr<Iter>()) -
                   (*other.template get_ptr<Iter>()));
     }
+  };
 
-    // contiguous
-    template <class Iter>
-    static constexpr add_pointer_t<Ref> arrow(const iterator_storage& self) {
-      return std::to_address(*(self.template get_ptr<Iter>()));
-    };
+  // Comparing with an unreachable_sentinel_t is false without a call, and
+  // comparing with a default_sentinel_t is the at_end_ entry of the iterator
+  enum class sentinel_kind : unsigned char { other, unreachable, at_end };
+
+  struct sentinel_vtable {
+    sentinel_kind kind_;
+    bool (*equal_)(const storage_type&, const sentinel_storage_type&);
+    // null if the underlying iterator is not batchable
+    size_t (*next_batch_)(storage_type&, const sentinel_storage_type&,
+                          std::span<batch_element>);
+    // sent - iter, null if Sent is not a sized_sentinel_for Iter
+    Diff (*distance_)(const storage_type&, const sentinel_storage_type&);
+  };
+
+  struct sentinel_vtable_gen {
+    template <class Iter, class Sent>
+    static constexpr sentinel_vtable generate() {
+      sentinel_vtable t{};
+      if constexpr (std::same_as<Sent, unreachable_sentinel_t>) {
+        t.kind_ = sentinel_kind::unreachable;
+      } else if constexpr (std::same_as<Sent, default_sentinel_t>) {
+        t.kind_ = sentinel_kind::at_end;
+      } else {
+        t.kind_ = sentinel_kind::other;
+      }
+      t.equal_ = &equal<Iter, Sent>;
+      if constexpr (is_batchable<Iter>) {
+        t.next_batch_ = &next_batch<Iter, Sent>;
+      }
+      if constexpr (std::sized_sentinel_for<Sent, Iter>) {
+        t.distance_ = &distance<Iter, Sent>;
+      }
+      return t;
+    }
+
+    static consteval sentinel_vtable generate_empty() {
+      sentinel_vtable t;
+      t.kind_ = sentinel_kind::other;
+      t.equal_ = [](const storage_type&, const sentinel_storage_type&) {
+        return true;
+      };
+      t.next_batch_ = [](storage_type&, const sentinel_storage_type&,
+                         std::span<batch_element>) -> size_t { return 0; };
+      t.distance_ = [](const storage_type&,
+                       const sentinel_storage_type&) -> Diff { return 0; };
+      return t;
+    }
+
+    // The sentinel is an erased iterator, the end of a common any_view. It
+    // is compared with the equal_ entry of the iterator vtable, like two
+    // iterators are
+    static constexpr bool equal_iterator(const storage_type& iter,
+                                         const sentinel_storage_type& sent) {
+      if (sent.is_singular()) return false;
+      const auto& last = *(sent.template get_ptr<storage_type>());
+      if (iter.get_vtable() != last.get_vtable()) return false;
+      if (iter.is_singular()) return true;
+      return (*(iter.get_vtable()->equal_))(iter, last);
+    }
+
+    template <bool RandomAccess>
+    static consteval sentinel_vtable generate_iterator() {
+      sentinel_vtable t{};
+      t.kind_ = sentinel_kind::other;
+      t.equal_ = &equal_iterator;
+      // the loop calls into the iterator vtable, as the iterator type is
+      // not known here
+      if constexpr (is_reference_v<Ref> || std::assignable_from<Ref&, Ref>) {
+        t.next_batch_ = [](storage_type& iter,
+                           const sentinel_storage_type& sent,
+                           std::span<batch_element> out) -> size_t {
+          if (iter.is_singular()) return 0;
+          auto* table = iter.get_vtable();
+          size_t n = 0;
+          for (; n != out.size() && !equal_iterator(iter, sent);
+               ++n, (*(table->increment_))(iter)) {
+            if constexpr (is_reference_v<Ref>) {
+              Ref r = (*(table->deref_))(iter);
+              out[n] = std::addressof(r);
+            } else {
+              out[n] = (*(table->deref_))(iter);
+            }
+          }
+          return n;
+        };
+      }
+      if constexpr (RandomAccess) {
+        t.distance_ = [](const storage_type& iter,
+                         const sentinel_storage_type& sent) -> Diff {
+          if (sent.is_singular() || iter.is_singular()) return 0;
+          const auto& last = *(sent.template get_ptr<storage_type>());
+          return (*(iter.get_vtable()->distance_to_))(last, iter);
+        };
+      }
+      return t;
+    }
+
+    template <class Iter, class Sent>
+    static constexpr bool equal(const storage_type& iter,
+                                const sentinel_storage_type& sent) {
+      instrument<instrumentation, Iter>(any_view_event::equal);
+      if (!has_sentinel<Sent>(sent) || iter.is_singular()) return false;
+      return *(iter.template get_ptr<Iter>()) == get_sentinel<Sent>(sent);
+    }
+
+    template <class Iter, class Sent>
+    static constexpr size_t next_batch(storage_type& iter,
+                                       const sentinel_storage_type& sent,
+                                       std::span<batch_element> out) {
+      if (!has_sentinel<Sent>(sent) || iter.is_singular()) return 0;
+      auto& it = *(iter.template get_ptr<Iter>());
+      const auto& last = get_sentinel<Sent>(sent);
+      size_t n = 0;
+      for (; n != out.size() && it != last; ++n, ++it) {
+        if constexpr (is_reference_v<Ref>) {
+          Ref r = *it;
+          out[n] = std::addressof(r);
+        } else {
+          out[n] = *it;
+        }
+      }
+      return n;
+    }
+
+    template <class Iter, class Sent>
+    static constexpr Diff distance(const storage_type& iter,
+                                   const sentinel_storage_type& sent) {
+      instrument<instrumentation, Iter>(any_view_event::distance_to);
+      if (!has_sentinel<Sent>(sent) || iter.is_singular()) return 0;
+      return Diff(get_sentinel<Sent>(sent) - *(iter.template get_ptr<Iter>()));
+    }
   };
 
+  template <class Iter, class Sent>
+  static constexpr sentinel_vtable sentinel_vtable_for =
+      sentinel_vtable_gen::template generate<Iter, Sent>();
+
+  template <bool RandomAccess>
+  static constexpr sentinel_vtable iterator_sentinel_vtable =
+      sentinel_vtable_gen::template generate_iterator<RandomAccess>();
+
+  static constexpr sentinel_vtable empty_sentinel_vtable =
+      sentinel_vtable_gen::generate_empty();
+};
+
+}  // namespace detail
+
+template <class Element, any_view_options Opts = any_view_options::input,
+          class Ref = Element&, class RValueRef = __rvalue_ref_t<Ref>,
+          class Diff = ptrdiff_t, class Policy = any_view_policy>
+class any_view
+    : public view_interface<
+          any_view<Element, Opts, Ref, RValueRef, Diff, Policy>> {
+ public:
+  struct any_iterator;
+  struct any_sentinel;
+
+  static constexpr any_view_options Traversal =
+      Opts & any_view_options::category_mask;
+  static constexpr bool is_view_copyable =
+      (Opts & any_view_options::copyable) != any_view_options::none;
+  static constexpr bool is_iterator_copyable =
+      Traversal >= any_view_options::forward;
+  // The elements of a contiguous range are an array, so the iterator is a
+  // plain pointer and iteration needs no indirect call at all
+  static constexpr bool is_contiguous =
+      Traversal == any_view_options::contiguous;
+
+  static constexpr bool is_sized =
+      (Opts & any_view_options::sized) == any_view_options::sized;
+  static constexpr bool is_approximately_sized =
+      (Opts & any_view_options::approximately_sized) ==
+      any_view_options::approximately_sized;
+
+  // The iterator of an indexed any_view is {view, index}: only the element
+  // access is an indirect call. The iterators refer to the any_view, so they
+  // are invalidated when it is moved or swapped
+  static constexpr bool is_indexed =
+      __flag_is_set(Opts, any_view_options::indexed);
+  static_assert(
+      !is_indexed || (Traversal == any_view_options::random_access &&
+                      is_sized &&
+                      !__flag_is_set(Opts, any_view_options::borrowed)),
+      "indexed requires random_access and sized, and the view cannot be "
+      "borrowed");
+
+  // iterator - sentinel is a constant time indirect call, for views whose
+  // sentinel is a sized_sentinel_for their iterator
+  static constexpr bool is_sized_sentinel =
+      __flag_is_set(Opts, any_view_options::sized_sentinel);
+
+  // The iterator of a counted any_view carries the number of remaining
+  // elements, and the sentinel is default_sentinel_t, so the end test is an
+  // integer compare instead of an indirect call
+  static constexpr bool is_counted =
+      __flag_is_set(Opts, any_view_options::counted) && !is_contiguous &&
+      !is_indexed;
+  static_assert(!__flag_is_set(Opts, any_view_options::counted) || is_sized,
+                "counted requires sized");
+
+  // begin() const and end() const iterate the const view. Like the const
+  // member functions of the standard views, they can be called concurrently
+  // from several threads
+  static constexpr bool is_const_iterable =
+      __flag_is_set(Opts, any_view_options::const_iterable);
+  static_assert(!is_const_iterable || !is_indexed,
+                "const_iterable cannot be combined with indexed");
+
+  // The sentinel of a common any_view is its iterator, for the views whose
+  // sentinel is their iterator, so that it can be passed to the algorithms
+  // that take a pair of iterators. end() is computed once and cached: the
+  // underlying range must not grow or shrink once end() was called
+  static constexpr bool is_common =
+      __flag_is_set(Opts, any_view_options::common) && !is_contiguous &&
+      !is_indexed;
+  static_assert(!is_common || Traversal >= any_view_options::forward,
+                "common requires forward");
+  static_assert(!is_common || !is_counted,
+                "common cannot be combined with counted");
+  static_assert(!is_common || !is_sized_sentinel ||
+                    Traversal >= any_view_options::random_access,
+                "common and sized_sentinel require random_access");
+
+  // A random access and sized view can be cut into sub-views of the same
+  // type, e.g. to be iterated on several threads
+  static constexpr bool is_splittable =
+      Traversal >= any_view_options::random_access && is_sized;
+
+  // The views of arithmetic elements have find, count, accumulate,
+  // min_element and max_element, which run inside the erased type instead
+  // of calling into the vtable for every element
+  static constexpr bool has_algorithms =
+      Traversal >= any_view_options::forward &&
+      is_arithmetic_v<remove_cv_t<Element>> &&
+      is_arithmetic_v<remove_cvref_t<Ref>>;
+
+  // The elements can be copied out of the view by a single indirect call,
+  // which runs the copy loop inside the erased type. It is only checked
+  // where it is used, as Element can be incomplete where the any_view is,
+  // e.g. struct Node { int v; any_view<Node, forward> kids; }
+  template <class E = remove_cv_t<Element>>
+  static constexpr bool has_bulk_copy = std::move_constructible<E> &&
+                                        std::constructible_from<E, Ref> &&
+                                        std::assignable_from<E&, Ref>;
+
+  using value_vector = std::vector<remove_cv_t<Element>>;
+
+  template <class T, bool HasT>
+  struct maybe_t : T {};
+
+  template <class T>
+  struct maybe_t<T, false> {};
+
+  using allocator_type = typename Policy::allocator_type;
+  using instrumentation = typename Policy::instrumentation;
+
+  using erased = detail::erased_iterator<Ref, RValueRef, Diff, Policy>;
+
+  using iterator_storage = typename erased::storage_type;
+  using sentinel_storage = typename erased::sentinel_storage_type;
+
+  using view_storage =
+      detail::storage<Policy::view_buffer_size, Policy::buffer_alignment,
+                      is_view_copyable, detail::no_extension, allocator_type,
+                      instrumentation>;
+
+  struct any_view_vtable;
+
+  using batch_element = typename erased::batch_element;
+  static constexpr bool is_batchable =
+      is_reference_v<Ref> ? Traversal >= any_view_options::forward
+                          : std::assignable_from<Ref&, Ref>;
+
+  using empty_iterator = typename erased::empty_iterator;
+  using empty_sentinel = typename erased::empty_sentinel;
+
   struct empty_iterator_category {};
   struct with_iterator_category {
    private:
@@ -238,9 +650,7 @@ class any_view
     using iterator_category = decltype(get_category());
   };
   constexpr static auto get_concept() {
-    if constexpr (Traversal == any_view_options::contiguous) {
-      return std::contiguous_iterator_tag{};
-    } else if constexpr (Traversal == any_view_options::random_access) {
+    if constexpr (Traversal >= any_view_options::random_access) {
       return std::random_access_iterator_tag{};
     } else if constexpr (Traversal == any_view_options::bidirectional) {
       return std::bidirectional_iterator_tag{};
@@ -275,12 +685,12 @@ class any_view
 
     constexpr Ref operator*() const {
       assert(!is_singular());
-      return (*(iter_vtable_->deref_))(iter_);
+      return (*(iter_.get_vtable()->deref_))(iter_);
     }
 
     constexpr any_iterator& operator++() {
       assert(!is_singular());
-      (*(iter_vtable_->increment_))(iter_);
+      (*(iter_.get_vtable()->increment_))(iter_);
       return *this;
     }
 
@@ -298,7 +708,7 @@ class any_view
       requires(Traversal >= any_view_options::bidirectional)
     {
       assert(!is_singular());
-      (*(iter_vtable_->decrement_))(iter_);
+      (*(iter_.get_vtable()->decrement_))(iter_);
       return *this;
     }
 
@@ -314,7 +724,7 @@ class any_view
       requires(Traversal >= any_view_options::random_access)
     {
       assert(!is_singular());
-      (*(iter_vtable_->advance_))(iter_, n);
+      (*(iter_.get_vtable()->advance_))(iter_, n);
       return *this;
     }
 
@@ -331,13 +741,6 @@ class any_view
       return *((*this) + n);
     }
 
-    constexpr std::add_pointer_t<Ref> operator->() const
-      requires(Traversal == any_view_options::contiguous)
-    {
-      assert(!is_singular());
-      return (*(iter_vtable_->arrow_))(iter_);
-    }
-
     friend constexpr bool operator<(const any_iterator& x,
                                     const any_iterator& y)
       requires(Traversal >= any_view_options::random_access)
@@ -397,60 +800,173 @@ class any_view
     {
       assert(!x.is_singular());
       assert(!y.is_singular());
-      assert(x.iter_vtable_ == y.iter_vtable_);
-      return (*(x.iter_vtable_->distance_to_))(x.iter_, y.iter_);
+      assert(x.iter_.get_vtable() == y.iter_.get_vtable());
+      return (*(x.iter_.get_vtable()->distance_to_))(x.iter_, y.iter_);
     }
 
     friend constexpr bool operator==(const any_iterator& x,
                                      const any_iterator& y)
       requires(Traversal >= any_view_options::forward)
     {
-      if (x.iter_vtable_ != y.iter_vtable_) return false;
-      if (!x.iter_vtable_) return true;
-      return (*(x.iter_vtable_->equal_))(x.iter_, y.iter_);
+      if (x.iter_.get_vtable() != y.iter_.get_vtable()) return false;
+      if (x.is_singular()) return true;
+      return (*(x.iter_.get_vtable()->equal_))(x.iter_, y.iter_);
+    }
+
+    // The underlying iterator if its type is exactly Iter, nullptr otherwise
+    template <class Iter>
+    constexpr Iter* target() noexcept {
+      if (!iter_.template holds<Iter>()) {
+        return nullptr;
+      }
+      return iter_.template get_ptr<Iter>();
+    }
+
+    template <class Iter>
+    constexpr const Iter* target() const noexcept {
+      return const_cast<any_iterator&>(*this).template target<Iter>();
     }
 
     friend constexpr RValueRef iter_move(const any_iterator& iter) {
       assert(!iter.is_singular());
-      return (*(iter.iter_vtable_->iter_move_))(iter.iter_);
+      return (*(iter.iter_.get_vtable()->iter_move_))(iter.iter_);
+    }
+
+    // Fills `out` with up to out.size() elements of [*this, last) and
+    // advances past them with a single indirect call. `out` must not be
+    // empty. Returns the number of elements written, which is 0 only if
+    // *this == last
+    constexpr size_t next_batch(std::span<batch_element> out,
+                                const any_sentinel& last)
+      requires is_batchable
+    {
+      assert(!is_singular());
+      assert(!out.empty());
+      return (*(last.sent_vtable_->next_batch_))(iter_, last.sent_, out);
     }
 
     // private:
-    const any_iterator_vtable* iter_vtable_ = nullptr;
+    using erased_type = erased;
+
     iterator_storage iter_;
 
+    constexpr explicit any_iterator(iterator_storage iter)
+        : iter_(std::move(iter)) {}
+
     template <class Iter>
-    constexpr any_iterator(const any_iterator_vtable* table, Iter iter)
-        : iter_vtable_(table), iter_(detail::type<Iter>{}, std::move(iter)) {}
+    constexpr any_iterator(const allocator_type& alloc, detail::type<Iter> t,
+                           Iter iter)
+        : iter_(allocator_arg, alloc, t, std::move(iter)) {}
 
     constexpr bool is_singular() const { return iter_.is_singular(); }
   };
 
-  using iterator = any_iterator;
+  struct indexed_iterator : with_iterator_category {
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = remove_cv_t<Element>;
+    using difference_type = Diff;
 
-  using sentinel_storage =
-      detail::storage<3 * sizeof(void*), sizeof(void*), true>;
-  struct any_sentinel_vtable {
-    bool (*equal_)(const iterator&, const any_sentinel&);
-  };
+    constexpr indexed_iterator() = default;
 
-  struct sentinel_vtable_gen {
-    template <class Iter, class Sent>
-    static constexpr auto generate() {
-      any_sentinel_vtable t;
-      t.equal_ = &equal<Iter, Sent>;
-      return t;
+    constexpr Ref operator*() const {
+      return (*(view_vtable_->deref_at_))(*view_, index_);
     }
 
-    template <class Iter, class Sent>
-    static constexpr bool equal(const iterator& iter,
-                                const any_sentinel& sent) {
-      if (sent.is_singular() || iter.is_singular()) return false;
-      return *(iter.iter_.template get_ptr<Iter>()) ==
-             *(sent.sent_.template get_ptr<Sent>());
+    constexpr Ref operator[](difference_type n) const {
+      return (*(view_vtable_->deref_at_))(*view_, index_ + n);
+    }
+
+    constexpr indexed_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+
+    constexpr indexed_iterator operator++(int) {
+      auto tmp = *this;
+      ++index_;
+      return tmp;
+    }
+
+    constexpr indexed_iterator& operator--() {
+      --index_;
+      return *this;
+    }
+
+    constexpr indexed_iterator operator--(int) {
+      auto tmp = *this;
+      --index_;
+      return tmp;
+    }
+
+    constexpr indexed_iterator& operator+=(difference_type n) {
+      index_ += n;
+      return *this;
+    }
+
+    constexpr indexed_iterator& operator-=(difference_type n) {
+      index_ -= n;
+      return *this;
+    }
+
+    friend constexpr indexed_iterator operator+(indexed_iterator it,
+                                                difference_type n) {
+      it += n;
+      return it;
+    }
+
+    friend constexpr indexed_iterator operator+(difference_type n,
+                                                indexed_iterator it) {
+      it += n;
+      return it;
+    }
+
+    friend constexpr indexed_iterator operator-(indexed_iterator it,
+                                                difference_type n) {
+      it -= n;
+      return it;
+    }
+
+    friend constexpr difference_type operator-(const indexed_iterator& x,
+                                               const indexed_iterator& y) {
+      assert(x.view_ == y.view_);
+      return x.index_ - y.index_;
     }
+
+    friend constexpr bool operator==(const indexed_iterator& x,
+                                     const indexed_iterator& y) {
+      assert(x.view_ == y.view_);
+      return x.index_ == y.index_;
+    }
+
+    friend constexpr auto operator<=>(const indexed_iterator& x,
+                                      const indexed_iterator& y) {
+      assert(x.view_ == y.view_);
+      return x.index_ <=> y.index_;
+    }
+
+    friend constexpr RValueRef iter_move(const indexed_iterator& iter) {
+      return (*(iter.view_vtable_->iter_move_at_))(*iter.view_, iter.index_);
+    }
+
+    // private:
+    const any_view_vtable* view_vtable_ = nullptr;
+    view_storage* view_ = nullptr;
+    Diff index_ = 0;
+
+    constexpr indexed_iterator(const any_view_vtable* table,
+                               view_storage* view, Diff index)
+        : view_vtable_(table), view_(view), index_(index) {}
   };
 
+  using iterator = conditional_t<
+      is_contiguous, add_pointer_t<Ref>,
+      conditional_t<
+          is_indexed, indexed_iterator,
+          conditional_t<is_counted, std::counted_iterator<any_iterator>,
+                        any_iterator>>>;
+
+  using any_sentinel_vtable = typename erased::sentinel_vtable;
+
   struct any_sentinel {
     constexpr any_sentinel() = default;
 
@@ -466,86 +982,154 @@ class any_view
 
     friend constexpr bool operator==(const iterator& iter,
                                      const any_sentinel& sent) {
-      return (*(sent.sent_vtable_->equal_))(iter, sent);
+      switch (sent.sent_vtable_->kind_) {
+        case erased::sentinel_kind::unreachable:
+          return false;
+        case erased::sentinel_kind::at_end:
+          if (iter.is_singular()) return false;
+          return (*(iter.iter_.get_vtable()->at_end_))(iter.iter_);
+        default:
+          return (*(sent.sent_vtable_->equal_))(iter.iter_, sent.sent_);
+      }
+    }
+
+    friend constexpr Diff operator-(const any_sentinel& sent,
+                                    const iterator& iter)
+      requires is_sized_sentinel
+    {
+      return (*(sent.sent_vtable_->distance_))(iter.iter_, sent.sent_);
+    }
+
+    friend constexpr Diff operator-(const iterator& iter,
+                                    const any_sentinel& sent)
+      requires is_sized_sentinel
+    {
+      return -(sent - iter);
     }
 
     // private:
+    using erased_type = erased;
+
     const any_sentinel_vtable* sent_vtable_ = nullptr;
     sentinel_storage sent_;
 
-    template <class Sent>
-    constexpr any_sentinel(const any_sentinel_vtable* table, Sent sent)
-        : sent_vtable_(table), sent_(detail::type<Sent>{}, std::move(sent)) {}
+    constexpr any_sentinel(const any_sentinel_vtable* table,
+                           sentinel_storage sent)
+        : sent_vtable_(table), sent_(std::move(sent)) {}
 
-    constexpr bool is_singular() const { return sent_.is_singular(); }
+    template <class Sent>
+    constexpr any_sentinel(const allocator_type& alloc,
+                           const any_sentinel_vtable* table, Sent sent)
+        : sent_vtable_(table),
+          sent_(erased::make_sentinel(alloc, std::move(sent))) {}
   };
 
-  using sentinel = any_sentinel;
-
-  struct empty_iterator {
-    static consteval any_iterator_vtable get_vtable() {
-      any_iterator_vtable t;
+  using sentinel = conditional_t<
+      is_contiguous, add_pointer_t<Ref>,
+      conditional_t<is_indexed, indexed_iterator,
+                    conditional_t<is_counted, default_sentinel_t,
+                                  conditional_t<is_common, any_iterator,
+                                                any_sentinel>>>>;
+
+  // R is an any_view, of any Element and options, whose iterator and
+  // sentinel erase into the same storage and vtables as ours. The end
+  // iterator of a common any_view is handed over as the sentinel of one
+  // that is not common
+  template <class R>
+  static constexpr bool is_flattenable = requires {
+    requires std::same_as<
+        typename std::ranges::iterator_t<R>::erased_type, erased>;
+    requires std::same_as<
+        typename std::ranges::sentinel_t<R>::erased_type, erased>;
+    requires !is_common || std::ranges::common_range<R>;
+  };
 
-      t.deref_ = [](const iterator_storage&) -> Ref {
-        assert(false && "Dereferencing empty iterator");
-        std::unreachable();
-      };
-      t.increment_ = [](iterator_storage&) {
-        assert(false && "Incrementing empty iterator");
-      };
-      t.iter_move_ = [](const iterator_storage&) -> RValueRef {
-        assert(false && "iter_moving empty iterator");
-        std::unreachable();
-      };
+  // A cursor owns the iterator and the sentinel together, so that a single
+  // indirect call advances, tests for the end and dereferences
+  static constexpr bool has_cursor = is_reference_v<Ref>;
 
-      if constexpr (Traversal >= any_view_options::forward) {
-        t.equal_ = [](const iterator_storage&, const iterator_storage&) {
-          return true;
-        };
-      }
+  using cursor_storage =
+      detail::storage<2 * Policy::iterator_buffer_size + 2 * sizeof(void*),
+                      Policy::buffer_alignment, false, detail::no_extension,
+                      allocator_type, instrumentation>;
 
-      if constexpr (Traversal >= any_view_options::bidirectional) {
-        t.decrement_ = [](iterator_storage&) {
-          assert(false && "Decrementing empty iterator");
-        };
-      }
+  struct any_cursor_vtable {
+    add_pointer_t<Ref> (*next_)(cursor_storage&);
+  };
 
-      if constexpr (Traversal >= any_view_options::random_access) {
-        t.advance_ = [](iterator_storage&, Diff) {
-          assert(false && "Advancing empty iterator");
-        };
-        t.distance_to_ = [](const iterator_storage&,
-                            const iterator_storage&) -> Diff {
-          assert(false && "Distance to empty iterator");
-          std::unreachable();
-        };
-      }
+  template <class Iter, class Sent>
+  struct cursor_state {
+    constexpr cursor_state(Iter iter, Sent sent)
+        : iter_(std::move(iter)), sent_(std::move(sent)) {}
 
-      if constexpr (Traversal == any_view_options::contiguous) {
-        t.arrow_ = [](const iterator_storage&) -> std::add_pointer_t<Ref> {
-          assert(false && "Arrow operator on empty iterator");
-          std::unreachable();
-        };
-      }
+    Iter iter_;
+    Sent sent_;
+    bool started_ = false;
+  };
 
+  struct cursor_vtable_gen {
+    template <class Iter, class Sent>
+    static constexpr auto generate() {
+      any_cursor_vtable t;
+      t.next_ = &next<Iter, Sent>;
       return t;
     }
 
-    static constexpr any_iterator_vtable vtable = get_vtable();
+    // the increment is deferred to the next call, so that the returned
+    // element stays valid even if the iterator stashes it
+    template <class Iter, class Sent>
+    static constexpr add_pointer_t<Ref> next(cursor_storage& self) {
+      auto& state = *(self.template get_ptr<cursor_state<Iter, Sent>>());
+      if (state.started_) {
+        ++state.iter_;
+      } else {
+        state.started_ = true;
+      }
+      if (state.iter_ == state.sent_) return nullptr;
+      Ref r = *state.iter_;
+      return std::addressof(r);
+    }
   };
 
-  struct empty_sentinel {
-    static consteval any_sentinel_vtable get_vtable() {
-      any_sentinel_vtable t;
-      t.equal_ = [](const iterator&, const any_sentinel&) { return true; };
-      return t;
+  struct any_cursor {
+    constexpr any_cursor() = default;
+
+    constexpr any_cursor(any_cursor&&) = default;
+
+    constexpr any_cursor& operator=(any_cursor&&) = default;
+
+    constexpr ~any_cursor() = default;
+
+    // returns the next element, or nullptr at the end
+    constexpr add_pointer_t<Ref> next() {
+      assert(!is_singular());
+      return (*(cursor_vtable_->next_))(cursor_);
     }
 
-    static constexpr any_sentinel_vtable vtable = get_vtable();
+    // private:
+    const any_cursor_vtable* cursor_vtable_ = nullptr;
+    cursor_storage cursor_;
+
+    template <class Iter, class Sent>
+    constexpr any_cursor(const allocator_type& alloc,
+                         const any_cursor_vtable* table, Iter iter, Sent sent)
+        : cursor_vtable_(table),
+          cursor_(allocator_arg, alloc,
+                  detail::type<cursor_state<Iter, Sent>>{}, std::move(iter),
+                  std::move(sent)) {}
+
+    constexpr bool is_singular() const { return cursor_.is_singular(); }
   };
 
-  using view_storage =
-      detail::storage<4 * sizeof(void*), sizeof(void*), is_view_copyable>;
+  struct empty_cursor {
+    static consteval any_cursor_vtable get_vtable() {
+      any_cursor_vtable t;
+      t.next_ = [](cursor_storage&) -> add_pointer_t<Ref> { return nullptr; };
+      return t;
+    }
+
+    static constexpr any_cursor_vtable vtable = get_vtable();
+  };
 
   struct sized_vtable {
     std::__make_unsigned_t<Diff> (*size_)(const view_storage&);
@@ -557,12 +1141,70 @@ class any_view
 
   struct unsized {};
 
+  struct cursor_view_vtable {
+    any_cursor (*cursor_)(view_storage&);
+  };
+
+  struct no_cursor {};
+
+  struct indexed_vtable {
+    Ref (*deref_at_)(view_storage&, Diff);
+    RValueRef (*iter_move_at_)(view_storage&, Diff);
+  };
+
+  struct const_iterable_vtable {
+    iterator (*begin_const_)(const view_storage&);
+    sentinel (*end_const_)(const view_storage&);
+  };
+
+  struct splittable_vtable {
+    any_view (*slice_)(view_storage&, Diff, Diff);
+  };
+
+  // callback for append_to on a container other than value_vector:
+  // reserve_(ctx_, n), then push_(ctx_, r) for each element, one indirect
+  // call per element
+  struct append_callback {
+    void* ctx_;
+    void (*reserve_)(void*, size_t);
+    void (*push_)(void*, Ref);
+  };
+
+  // null if the elements cannot be copied
+  struct bulk_copy_vtable {
+    void (*append_to_vector_)(view_storage&, value_vector&) = nullptr;
+    void (*append_)(view_storage&, append_callback) = nullptr;
+    size_t (*copy_to_)(view_storage&, std::span<remove_cv_t<Element>>) =
+        nullptr;
+  };
+
+  struct algorithms_vtable {
+    iterator (*find_)(view_storage&, const remove_cv_t<Element>&);
+    Diff (*count_)(view_storage&, const remove_cv_t<Element>&);
+    remove_cv_t<Element> (*accumulate_)(view_storage&, remove_cv_t<Element>);
+    iterator (*min_element_)(view_storage&);
+    iterator (*max_element_)(view_storage&);
+  };
+
+  // callback for the internal iteration: fn_(ctx_, r) for each element, one
+  // indirect call per element
+  struct for_each_callback {
+    void* ctx_;
+    void (*fn_)(void*, Ref);
+  };
+
   struct any_view_vtable
       : conditional_t<is_sized, sized_vtable,
                       conditional_t<is_approximately_sized,
-                                    approximately_sized_vtable, unsized>> {
+                                    approximately_sized_vtable, unsized>>,
+        conditional_t<has_cursor, cursor_view_vtable, no_cursor>,
+        maybe_t<indexed_vtable, is_indexed>,
+        maybe_t<const_iterable_vtable, is_const_iterable>,
+        maybe_t<splittable_vtable, is_splittable>,
+        maybe_t<algorithms_vtable, has_algorithms>, bulk_copy_vtable {
     iterator (*begin_)(view_storage&);
     sentinel (*end_)(view_storage&);
+    void (*for_each_)(view_storage&, for_each_callback);
   };
 
   struct view_vtable_gen {
@@ -571,6 +1213,33 @@ class any_view
       any_view_vtable t;
       t.begin_ = &begin<View>;
       t.end_ = &end<View>;
+      t.for_each_ = &for_each<View>;
+      if constexpr (has_cursor) {
+        t.cursor_ = &cursor<View>;
+      }
+      if constexpr (is_indexed) {
+        t.deref_at_ = &deref_at<View>;
+        t.iter_move_at_ = &iter_move_at<View>;
+      }
+      if constexpr (is_const_iterable) {
+        t.begin_const_ = &begin_const<View>;
+        t.end_const_ = &end_const<View>;
+      }
+      if constexpr (is_splittable) {
+        t.slice_ = &slice<View>;
+      }
+      if constexpr (has_bulk_copy<>) {
+        t.append_to_vector_ = &append_to_vector<View>;
+        t.append_ = &append<View>;
+        t.copy_to_ = &copy_to<View>;
+      }
+      if constexpr (has_algorithms) {
+        t.find_ = &find<View>;
+        t.count_ = &count<View>;
+        t.accumulate_ = &accumulate<View>;
+        t.min_element_ = &min_element<View>;
+        t.max_element_ = &max_element<View>;
+      }
       if constexpr (is_sized) {
         t.size_ = &size<View>;
       } else if constexpr (is_approximately_sized) {
@@ -582,17 +1251,406 @@ class any_view
 
     template <class View>
     static constexpr iterator begin(view_storage& v) {
-      auto& view = *(v.template get_ptr<View>());
-      return any_iterator(&iter_vtable<std::ranges::iterator_t<View>>,
-                          std::ranges::begin(view));
+      detail::instrument<instrumentation, View>(any_view_event::begin);
+      if constexpr (is_indexed) {
+        return indexed_iterator(&view_vtable<View>, &v, 0);
+      } else {
+        return begin_of(*(v.template get_ptr<View>()), v.get_allocator());
+      }
     }
 
     template <class View>
     static constexpr sentinel end(view_storage& v) {
+      detail::instrument<instrumentation, View>(any_view_event::end);
+      if constexpr (is_indexed) {
+        return indexed_iterator(
+            &view_vtable<View>, &v,
+            Diff(std::ranges::distance(*(v.template get_ptr<View>()))));
+      } else {
+        return end_of(*(v.template get_ptr<View>()), v.get_allocator());
+      }
+    }
+
+    template <class View>
+    static constexpr iterator begin_const(const view_storage& v) {
+      detail::instrument<instrumentation, View>(any_view_event::begin);
+      return begin_of(*(v.template get_ptr<View>()), v.get_allocator());
+    }
+
+    template <class View>
+    static constexpr sentinel end_const(const view_storage& v) {
+      detail::instrument<instrumentation, View>(any_view_event::end);
+      return end_of(*(v.template get_ptr<View>()), v.get_allocator());
+    }
+
+    // R is View or const View
+    template <class R>
+    static constexpr iterator begin_of(R& view, const allocator_type& alloc) {
+      if constexpr (is_contiguous) {
+        return std::ranges::data(view);
+      } else if constexpr (is_counted) {
+        return iterator(any_iterator_of(view, alloc),
+                        Diff(std::ranges::size(view)));
+      } else {
+        return any_iterator_of(view, alloc);
+      }
+    }
+
+    // An any_view with the same erased iterator hands over its iterator
+    // instead of being wrapped, so there is one indirect call per operation
+    template <class R>
+    static constexpr any_iterator any_iterator_of(R& view,
+                                                  const allocator_type& alloc) {
+      if constexpr (is_flattenable<R>) {
+        return any_iterator(std::move(std::ranges::begin(view).iter_));
+      } else {
+        return any_iterator(alloc, detail::type<std::ranges::iterator_t<R>>{},
+                            std::ranges::begin(view));
+      }
+    }
+
+    template <class R>
+    static constexpr sentinel end_of(R& view, const allocator_type& alloc) {
+      if constexpr (is_contiguous) {
+        return std::ranges::data(view) + std::ranges::distance(view);
+      } else if constexpr (is_counted) {
+        return default_sentinel;
+      } else if constexpr (is_common) {
+        if constexpr (is_flattenable<R>) {
+          return any_iterator(std::move(std::ranges::end(view).iter_));
+        } else {
+          return any_iterator(alloc,
+                              detail::type<std::ranges::iterator_t<R>>{},
+                              std::ranges::end(view));
+        }
+      } else if constexpr (is_flattenable<R> &&
+                           std::ranges::common_range<R>) {
+        return any_sentinel(
+            &erased::template iterator_sentinel_vtable<
+                std::ranges::random_access_range<R>>,
+            sentinel_storage(std::allocator_arg, alloc,
+                             detail::type<typename erased::storage_type>{},
+                             std::move(std::ranges::end(view).iter_)));
+      } else if constexpr (is_flattenable<R>) {
+        auto sent = std::ranges::end(view);
+        return any_sentinel(sent.sent_vtable_, std::move(sent.sent_));
+      } else {
+        using Iter = std::ranges::iterator_t<R>;
+        using Sent = std::ranges::sentinel_t<R>;
+        return any_sentinel(alloc,
+                            &erased::template sentinel_vtable_for<Iter, Sent>,
+                            std::ranges::end(view));
+      }
+    }
+
+    template <class View>
+    static constexpr any_cursor cursor(view_storage& v) {
       auto& view = *(v.template get_ptr<View>());
-      return any_sentinel(&sent_vtable<std::ranges::iterator_t<View>,
+      return any_cursor(v.get_allocator(),
+                        &cursor_vtable<std::ranges::iterator_t<View>,
                                        std::ranges::sentinel_t<View>>,
-                          std::ranges::end(view));
+                        std::ranges::begin(view), std::ranges::end(view));
+    }
+
+    template <class View>
+    static constexpr Ref deref_at(view_storage& v, Diff n) {
+      detail::instrument<instrumentation, View>(any_view_event::deref);
+      auto& view = *(v.template get_ptr<View>());
+      return std::ranges::begin(
+          view)[std::ranges::range_difference_t<View>(n)];
+    }
+
+    template <class View>
+    static constexpr RValueRef iter_move_at(view_storage& v, Diff n) {
+      detail::instrument<instrumentation, View>(any_view_event::iter_move);
+      auto& view = *(v.template get_ptr<View>());
+      return std::ranges::iter_move(
+          std::ranges::begin(view) + std::ranges::range_difference_t<View>(n));
+    }
+
+    // the sub-view refers to the iterators of the erased view
+    template <class View>
+    static constexpr any_view slice(view_storage& v, Diff first, Diff last) {
+      auto& view = *(v.template get_ptr<View>());
+      using D = std::ranges::range_difference_t<View>;
+      auto it = std::ranges::begin(view);
+      return any_view(allocator_arg, v.get_allocator(),
+                      std::ranges::subrange(it + D(first), it + D(last)));
+    }
+
+    // The elements of View are an array of Element, which the algorithms
+    // walk with the loops of contiguous_algorithm.hpp
+    template <class View>
+    static constexpr bool is_element_array =
+        std::ranges::contiguous_range<View> &&
+        std::ranges::sized_range<View> &&
+        std::same_as<std::ranges::range_value_t<View>, remove_cv_t<Element>> &&
+        is_lvalue_reference_v<std::ranges::range_reference_t<View>>;
+
+    // our iterator to the element of the erased view that `it` points to
+    template <class View>
+    static constexpr iterator iterator_at(view_storage& v,
+                                          std::ranges::iterator_t<View> it) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_contiguous) {
+        return std::to_address(it);
+      } else if constexpr (is_indexed) {
+        return indexed_iterator(&view_vtable<View>, &v,
+                                Diff(it - std::ranges::begin(view)));
+      } else {
+        Diff rest = 0;
+        if constexpr (is_counted) {
+          rest = Diff(std::ranges::distance(it, std::ranges::end(view)));
+        }
+        any_iterator iter = [&] {
+          if constexpr (is_flattenable<View>) {
+            return any_iterator(std::move(it.iter_));
+          } else {
+            return any_iterator(v.get_allocator(),
+                                detail::type<std::ranges::iterator_t<View>>{},
+                                std::move(it));
+          }
+        }();
+        if constexpr (is_counted) {
+          return iterator(std::move(iter), rest);
+        } else {
+          return iter;
+        }
+      }
+    }
+
+    template <class View>
+    static constexpr iterator element_at(view_storage& v, size_t i) {
+      auto& view = *(v.template get_ptr<View>());
+      using D = std::ranges::range_difference_t<View>;
+      return iterator_at<View>(v, std::ranges::begin(view) + D(i));
+    }
+
+    // the elements as the algorithms through our iterator see them
+    struct as_ref {
+      template <class T>
+      constexpr Ref operator()(T&& elem) const {
+        return static_cast<Ref>(std::forward<T>(elem));
+      }
+    };
+
+    // View is an any_view of the same elements. The slots call its members,
+    // which run the loop with one indirect call and keep the contiguous,
+    // vectorized and memmove paths of the view it erases
+    template <class View>
+    static constexpr bool is_forwarded =
+        is_flattenable<View> &&
+        std::same_as<std::ranges::range_value_t<View>, remove_cv_t<Element>>;
+
+    template <class View>
+    static constexpr iterator find(view_storage& v,
+                                   const remove_cv_t<Element>& value) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> &&
+                    requires { view.find(value); }) {
+        return iterator_at<View>(v, view.find(value));
+      } else if constexpr (is_element_array<View>) {
+        return element_at<View>(
+            v, detail::find(std::ranges::data(view),
+                            size_t(std::ranges::size(view)), value));
+      } else {
+        return iterator_at<View>(v, std::ranges::find(view, value, as_ref{}));
+      }
+    }
+
+    template <class View>
+    static constexpr Diff count(view_storage& v,
+                                const remove_cv_t<Element>& value) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> &&
+                    requires { view.count(value); }) {
+        return Diff(view.count(value));
+      } else if constexpr (is_element_array<View>) {
+        return Diff(detail::count(std::ranges::data(view),
+                                  size_t(std::ranges::size(view)), value));
+      } else {
+        return Diff(std::ranges::count(view, value, as_ref{}));
+      }
+    }
+
+    template <class View>
+    static constexpr remove_cv_t<Element> accumulate(
+        view_storage& v, remove_cv_t<Element> init) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> &&
+                    requires { view.accumulate(init); }) {
+        return view.accumulate(init);
+      } else if constexpr (is_element_array<View>) {
+        return detail::accumulate(std::ranges::data(view),
+                                  size_t(std::ranges::size(view)), init);
+      } else {
+        for (auto&& elem : view) {
+          init = init + as_ref{}(std::forward<decltype(elem)>(elem));
+        }
+        return init;
+      }
+    }
+
+    template <class View>
+    static constexpr iterator min_element(view_storage& v) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> && requires { view.min_element(); }) {
+        return iterator_at<View>(v, view.min_element());
+      } else if constexpr (is_element_array<View>) {
+        return element_at<View>(
+            v, detail::min_element(std::ranges::data(view),
+                                   size_t(std::ranges::size(view))));
+      } else {
+        return iterator_at<View>(
+            v, std::ranges::min_element(view, {}, as_ref{}));
+      }
+    }
+
+    template <class View>
+    static constexpr iterator max_element(view_storage& v) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> && requires { view.max_element(); }) {
+        return iterator_at<View>(v, view.max_element());
+      } else if constexpr (is_element_array<View>) {
+        return element_at<View>(
+            v, detail::max_element(std::ranges::data(view),
+                                   size_t(std::ranges::size(view))));
+      } else {
+        return iterator_at<View>(
+            v, std::ranges::max_element(view, {}, as_ref{}));
+      }
+    }
+
+    // the number of elements if it is known without walking the view, 0
+    // otherwise
+    template <class View>
+    static constexpr size_t expected_size(View& view) {
+      if constexpr (std::ranges::approximately_sized_range<View>) {
+        return size_t(std::ranges::reserve_hint(view));
+      } else {
+        return 0;
+      }
+    }
+
+    // Makes room for n more elements, without giving up the geometric
+    // growth of the container when it is appended to many times
+    template <class Container>
+    static constexpr void reserve_more(Container& c, size_t n) {
+      if constexpr (requires {
+                      c.capacity();
+                      c.reserve(n);
+                    }) {
+        if (c.capacity() - c.size() < n) {
+          c.reserve(std::max(c.size() + n, 2 * c.size()));
+        }
+      }
+    }
+
+    template <class Container>
+    static constexpr void push_back(Container& c, Ref r) {
+      if constexpr (requires { c.emplace_back(std::forward<Ref>(r)); }) {
+        c.emplace_back(std::forward<Ref>(r));
+      } else {
+        c.insert(c.end(), std::forward<Ref>(r));
+      }
+    }
+
+    template <class View>
+    static constexpr bool is_trivial_array =
+        is_element_array<View> &&
+        is_trivially_copyable_v<remove_cv_t<Element>>;
+
+    template <class View>
+    static constexpr void append_to_vector(view_storage& v,
+                                           value_vector& vec) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> && requires { view.append_to(vec); }) {
+        view.append_to(vec);
+      } else if constexpr (is_trivial_array<View>) {
+        // a memmove
+        auto* first = std::ranges::data(view);
+        vec.insert(vec.end(), first, first + std::ranges::size(view));
+#if __cpp_lib_containers_ranges >= 202202L
+      } else if constexpr (std::ranges::sized_range<View> &&
+                           std::ranges::forward_range<View>) {
+        vec.append_range(
+            std::views::transform(std::ranges::ref_view(view), as_ref{}));
+#endif
+      } else {
+        reserve_more(vec, expected_size(view));
+        for (auto&& elem : view) {
+          vec.emplace_back(as_ref{}(std::forward<decltype(elem)>(elem)));
+        }
+      }
+    }
+
+    // the container that append_to fills through c
+    struct callback_container {
+      append_callback c_;
+
+      constexpr size_t size() const { return 0; }
+      constexpr size_t capacity() const { return 0; }
+      constexpr void reserve(size_t n) { (*c_.reserve_)(c_.ctx_, n); }
+      constexpr void emplace_back(Ref r) {
+        (*c_.push_)(c_.ctx_, std::forward<Ref>(r));
+      }
+    };
+
+    template <class View>
+    static constexpr void append(view_storage& v, append_callback c) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> &&
+                    requires(callback_container& cc) { view.append_to(cc); }) {
+        callback_container cc{c};
+        view.append_to(cc);
+      } else {
+        (*c.reserve_)(c.ctx_, expected_size(view));
+        for (auto&& elem : view) {
+          (*c.push_)(c.ctx_, std::forward<decltype(elem)>(elem));
+        }
+      }
+    }
+
+    template <class View>
+    static constexpr size_t copy_to(view_storage& v,
+                                    std::span<remove_cv_t<Element>> out) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> && requires { view.copy_to(out); }) {
+        return view.copy_to(out);
+      } else if constexpr (is_trivial_array<View>) {
+        size_t n = std::min(out.size(), size_t(std::ranges::size(view)));
+        if consteval {
+          std::ranges::copy_n(std::ranges::data(view), n, out.data());
+        } else {
+          if (n != 0) {
+            std::memcpy(out.data(), std::ranges::data(view),
+                        n * sizeof(remove_cv_t<Element>));
+          }
+        }
+        return n;
+      } else {
+        size_t n = 0;
+        auto last = std::ranges::end(view);
+        for (auto it = std::ranges::begin(view); n != out.size() && it != last;
+             ++it) {
+          out[n++] = as_ref{}(*it);
+        }
+        return n;
+      }
+    }
+
+    template <class View>
+    static constexpr void for_each(view_storage& v, for_each_callback fn) {
+      auto& view = *(v.template get_ptr<View>());
+      if constexpr (is_forwarded<View> &&
+                    requires(void (*f)(Ref)) { view.for_each(f); }) {
+        view.for_each(
+            [fn](Ref r) { (*fn.fn_)(fn.ctx_, std::forward<Ref>(r)); });
+      } else {
+        for (auto&& elem : view) {
+          (*fn.fn_)(fn.ctx_, std::forward<decltype(elem)>(elem));
+        }
+      }
     }
 
     template <class View>
@@ -612,12 +1670,68 @@ class any_view
   struct empty_view_ {
     static consteval any_view_vtable get_vtable() {
       any_view_vtable t;
-      t.begin_ = [](view_storage&) -> iterator {
-        return any_iterator(&empty_iterator::vtable, empty_iterator{});
+      t.begin_ = [](view_storage& v) -> iterator {
+        if constexpr (is_indexed) {
+          return indexed_iterator(&vtable, &v, 0);
+        } else {
+          return begin_of(v.get_allocator());
+        }
       };
-      t.end_ = [](view_storage&) -> sentinel {
-        return any_sentinel(&empty_sentinel::vtable, empty_sentinel{});
+      t.end_ = [](view_storage& v) -> sentinel {
+        if constexpr (is_indexed) {
+          return indexed_iterator(&vtable, &v, 0);
+        } else {
+          return end_of(v.get_allocator());
+        }
       };
+      if constexpr (is_const_iterable) {
+        t.begin_const_ = [](const view_storage& v) -> iterator {
+          return begin_of(v.get_allocator());
+        };
+        t.end_const_ = [](const view_storage& v) -> sentinel {
+          return end_of(v.get_allocator());
+        };
+      }
+      t.for_each_ = [](view_storage&, for_each_callback) {};
+      if constexpr (has_bulk_copy<>) {
+        t.append_to_vector_ = [](view_storage&, value_vector&) {};
+        t.append_ = [](view_storage&, append_callback) {};
+        t.copy_to_ = [](view_storage&, std::span<remove_cv_t<Element>>) {
+          return size_t(0);
+        };
+      }
+      if constexpr (has_algorithms) {
+        t.find_ = [](view_storage& v, const remove_cv_t<Element>&) {
+          return (*vtable.begin_)(v);
+        };
+        t.count_ = [](view_storage&, const remove_cv_t<Element>&) {
+          return Diff(0);
+        };
+        t.accumulate_ = [](view_storage&, remove_cv_t<Element> init) {
+          return init;
+        };
+        t.min_element_ = [](view_storage& v) { return (*vtable.begin_)(v); };
+        t.max_element_ = [](view_storage& v) { return (*vtable.begin_)(v); };
+      }
+      if constexpr (is_splittable) {
+        t.slice_ = [](view_storage&, Diff, Diff) { return any_view(); };
+      }
+      if constexpr (is_indexed) {
+        t.deref_at_ = [](view_storage&, Diff) -> Ref {
+          assert(false && "Dereferencing empty iterator");
+          std::unreachable();
+        };
+        t.iter_move_at_ = [](view_storage&, Diff) -> RValueRef {
+          assert(false && "Dereferencing empty iterator");
+          std::unreachable();
+        };
+      }
+      if constexpr (has_cursor) {
+        t.cursor_ = [](view_storage& v) -> any_cursor {
+          return any_cursor(v.get_allocator(), &empty_cursor::vtable,
+                            empty_iterator{}, empty_sentinel{});
+        };
+      }
       if constexpr (is_sized) {
         t.size_ = [](const view_storage&) -> std::__make_unsigned_t<Diff> {
           return 0;
@@ -631,11 +1745,68 @@ class any_view
       return t;
     }
 
+    static constexpr iterator begin_of(const allocator_type& alloc) {
+      if constexpr (is_contiguous) {
+        return nullptr;
+      } else if constexpr (is_counted) {
+        return iterator(any_iterator(alloc, detail::type<empty_iterator>{},
+                                     empty_iterator{}),
+                        0);
+      } else {
+        return any_iterator(alloc, detail::type<empty_iterator>{},
+                            empty_iterator{});
+      }
+    }
+
+    static constexpr sentinel end_of(const allocator_type& alloc) {
+      if constexpr (is_contiguous) {
+        return nullptr;
+      } else if constexpr (is_counted) {
+        return default_sentinel;
+      } else if constexpr (is_common) {
+        return any_iterator(alloc, detail::type<empty_iterator>{},
+                            empty_iterator{});
+      } else {
+        return any_sentinel(alloc, &erased::empty_sentinel_vtable,
+                            empty_sentinel{});
+      }
+    }
+
     static constexpr any_view_vtable vtable = get_vtable();
   };
 
   template <class View>
   consteval static bool view_options_constraint() {
+    if constexpr (__flag_is_set(Opts, any_view_options::borrowed) &&
+                  !std::ranges::borrowed_range<View>) {
+      return false;
+    }
+
+    if constexpr (is_view_copyable && !std::copyable<View>) {
+      return false;
+    }
+
+    if constexpr (is_const_iterable) {
+      if constexpr (!range_options_constraint<const View>()) {
+        return false;
+      }
+    }
+
+    return range_options_constraint<View>();
+  }
+
+  // R is the view, or the const view if const_iterable
+  template <class R>
+  consteval static bool range_options_constraint() {
+    if constexpr (!std::ranges::range<R>) {
+      return false;
+    } else {
+      return range_options_constraint_impl<R>();
+    }
+  }
+
+  template <class View>
+  consteval static bool range_options_constraint_impl() {
     if constexpr (is_sized && !std::ranges::sized_range<View>) {
       return false;
     }
@@ -645,12 +1816,13 @@ class any_view
       return false;
     }
 
-    if constexpr (__flag_is_set(Opts, any_view_options::borrowed) &&
-                  !std::ranges::borrowed_range<View>) {
+    if constexpr (is_common && !std::ranges::common_range<View>) {
       return false;
     }
 
-    if constexpr (is_view_copyable && !std::copyable<View>) {
+    if constexpr (is_sized_sentinel &&
+                  !std::sized_sentinel_for<std::ranges::sentinel_t<View>,
+                                           std::ranges::iterator_t<View>>) {
       return false;
     }
 
@@ -678,7 +1850,15 @@ class any_view
 
     constexpr auto cat_mask = Opts & any_view_options::category_mask;
     if constexpr (cat_mask == any_view_options::contiguous) {
-      return std::ranges::contiguous_range<View>;
+      // the pointer arithmetic is only valid if the elements are not
+      // converted to a different type (e.g. derived to base)
+      if constexpr (std::ranges::contiguous_range<View>) {
+        return std::convertible_to<
+            std::remove_reference_t<std::ranges::range_reference_t<View>> (*)[],
+            std::remove_reference_t<Ref> (*)[]>;
+      } else {
+        return false;
+      }
     } else if constexpr (cat_mask == any_view_options::random_access) {
       return std::ranges::random_access_range<View>;
     } else if constexpr (cat_mask == any_view_options::bidirectional) {
@@ -701,6 +1881,16 @@ class any_view
         view_(detail::type<views::all_t<Range>>{},
               views::all(std::forward<Range>(range))) {}
 
+  template <class Range>
+    requires(!std::same_as<remove_cvref_t<Range>, any_view> &&
+             std::ranges::viewable_range<Range> &&
+             view_options_constraint<views::all_t<Range>>())
+  constexpr any_view(allocator_arg_t, const allocator_type& alloc,
+                     Range&& range)
+      : view_vtable_(&view_vtable<views::all_t<Range>>),
+        view_(allocator_arg, alloc, detail::type<views::all_t<Range>>{},
+              views::all(std::forward<Range>(range))) {}
+
   constexpr any_view(const any_view&)
     requires is_view_copyable
   = default;
@@ -708,6 +1898,7 @@ class any_view
   constexpr any_view(any_view&& other) noexcept
       : view_vtable_(other.view_vtable_), view_(std::move(other.view_)) {
     other.view_vtable_ = &empty_view_::vtable;
+    other.end_cache_ = end_cache();
   }
 
   constexpr any_view& operator=(const any_view&)
@@ -724,7 +1915,120 @@ class any_view
   constexpr ~any_view() = default;
 
   constexpr iterator begin() { return (*(view_vtable_->begin_))(view_); }
-  constexpr sentinel end() { return (*(view_vtable_->end_))(view_); }
+  constexpr sentinel end() {
+    if constexpr (is_common) {
+      if (!end_cache_.end_) {
+        end_cache_.end_.emplace((*(view_vtable_->end_))(view_));
+      }
+      return *end_cache_.end_;
+    } else {
+      return (*(view_vtable_->end_))(view_);
+    }
+  }
+
+  constexpr iterator begin() const
+    requires is_const_iterable
+  {
+    return (*(view_vtable_->begin_const_))(view_);
+  }
+
+  constexpr sentinel end() const
+    requires is_const_iterable
+  {
+    return (*(view_vtable_->end_const_))(view_);
+  }
+
+  // Single-pass iteration with one indirect call per element:
+  //   auto c = v.cursor();
+  //   while (auto* p = c.next()) { ... }
+  constexpr any_cursor cursor()
+    requires has_cursor
+  {
+    return (*(view_vtable_->cursor_))(view_);
+  }
+
+  // Internal iteration: the whole loop runs inside the erased type, so the
+  // only indirect call per element is the call to `fn`.
+  // The caller can list the view types it expects, e.g.
+  //   v.for_each<std::ranges::ref_view<std::vector<int>>>(fn);
+  // If the erased view is one of them, the loop is inlined in the caller and
+  // there is no indirect call at all
+  template <class... Expected, class Fn>
+    requires std::invocable<Fn&, Ref>
+  constexpr Fn for_each(Fn fn) {
+    static_assert((view_options_constraint<Expected>() && ...),
+                  "an expected type can never be the erased view");
+    if ((for_each_if<Expected>(fn) || ...)) {
+      return fn;
+    }
+
+    if consteval {
+      // a constant expression cannot cast the context back from void*
+      for (auto&& r : *this) {
+        std::invoke(fn, std::forward<Ref>(r));
+      }
+    } else {
+      for_each_callback cb{std::addressof(fn), [](void* ctx, Ref r) {
+                             std::invoke(*static_cast<Fn*>(ctx),
+                                         std::forward<Ref>(r));
+                           }};
+      (*(view_vtable_->for_each_))(view_, cb);
+    }
+    return fn;
+  }
+
+  // Appends the elements to c, e.g. a std::vector, with the copy loop
+  // inside the erased type. A std::vector of the value type is filled by a
+  // single indirect call, with a memmove for an array of trivially copyable
+  // elements. Other containers take one indirect call per element
+  template <class Container>
+    requires has_bulk_copy<> &&
+             (requires(Container& c, Ref r) {
+               c.emplace_back(std::forward<Ref>(r));
+             } || requires(Container& c, Ref r) {
+               c.insert(c.end(), std::forward<Ref>(r));
+             })
+  constexpr Container& append_to(Container& c) {
+    if constexpr (std::same_as<Container, value_vector>) {
+      (*(view_vtable_->append_to_vector_))(view_, c);
+    } else if consteval {
+      // a constant expression cannot cast the context back from void*
+      view_vtable_gen::reserve_more(c, view_vtable_gen::expected_size(*this));
+      for (auto&& r : *this) {
+        view_vtable_gen::push_back(c, std::forward<Ref>(r));
+      }
+    } else {
+      append_callback cb{
+          std::addressof(c),
+          [](void* ctx, size_t n) {
+            view_vtable_gen::reserve_more(*static_cast<Container*>(ctx), n);
+          },
+          [](void* ctx, Ref r) {
+            view_vtable_gen::push_back(*static_cast<Container*>(ctx),
+                                       std::forward<Ref>(r));
+          }};
+      (*(view_vtable_->append_))(view_, cb);
+    }
+    return c;
+  }
+
+  // Copies the first elements to out, as many as fit, and returns their
+  // number. An array of trivially copyable elements is copied by memcpy
+  constexpr size_t copy_to(std::span<remove_cv_t<Element>> out)
+    requires has_bulk_copy<>
+  {
+    return (*(view_vtable_->copy_to_))(view_, out);
+  }
+
+  // std::ranges::to<std::vector>(v) constructs the vector from the view
+  // when it can, so it is filled by append_to
+  constexpr explicit operator value_vector()
+    requires has_bulk_copy<>
+  {
+    value_vector vec;
+    append_to(vec);
+    return vec;
+  }
 
   constexpr std::__make_unsigned_t<Diff> size() const
     requires(is_sized)
@@ -742,35 +2046,301 @@ class any_view
     }
   }
 
+  constexpr allocator_type get_allocator() const noexcept {
+    return view_.get_allocator();
+  }
+
+  // The elements [first, last) as a view of the same type. The sub-view
+  // refers to this view: it is valid until this view is destroyed, moved or
+  // swapped, and can be iterated concurrently with the other sub-views
+  constexpr any_view slice(Diff first, Diff last)
+    requires is_splittable
+  {
+    assert(0 <= first && first <= last && last <= Diff(size()));
+    return (*(view_vtable_->slice_))(view_, first, last);
+  }
+
+  // n sub-views of nearly equal sizes, in order, that together are this view
+  constexpr std::vector<any_view> split(size_t n)
+    requires is_splittable
+  {
+    assert(n > 0);
+    std::vector<any_view> parts;
+    parts.reserve(n);
+    Diff total = Diff(size());
+    Diff first = 0;
+    for (size_t i = 0; i != n; ++i) {
+      Diff last = Diff(total * Diff(i + 1) / Diff(n));
+      parts.push_back(slice(first, last));
+      first = last;
+    }
+    return parts;
+  }
+
+  // The algorithms over arithmetic elements, e.g. v.count(0) is
+  // std::ranges::count(v, 0), with one indirect call in total instead of
+  // several per element. The loops over an array of Element are vectorized
+  constexpr iterator find(const remove_cv_t<Element>& value)
+    requires has_algorithms
+  {
+    return (*(view_vtable_->find_))(view_, value);
+  }
+
+  constexpr Diff count(const remove_cv_t<Element>& value)
+    requires has_algorithms
+  {
+    return (*(view_vtable_->count_))(view_, value);
+  }
+
+  // The elements are added to init in order, like std::accumulate
+  constexpr remove_cv_t<Element> accumulate(remove_cv_t<Element> init = {})
+    requires has_algorithms
+  {
+    return (*(view_vtable_->accumulate_))(view_, init);
+  }
+
+  constexpr iterator min_element()
+    requires has_algorithms
+  {
+    return (*(view_vtable_->min_element_))(view_);
+  }
+
+  constexpr iterator max_element()
+    requires has_algorithms
+  {
+    return (*(view_vtable_->max_element_))(view_);
+  }
+
+  // Like std::any_cast: the erased view if its type is exactly View,
+  // nullptr otherwise, e.g.
+  //   if (auto* r = v.target<std::ranges::ref_view<std::vector<int>>>()) {
+  //     // typed loop over *r
+  //   }
+  template <class View>
+  constexpr View* target() noexcept {
+    static_assert(view_options_constraint<View>(),
+                  "View can never be the erased view");
+    if (view_vtable_ != &view_vtable<View>) {
+      return nullptr;
+    }
+    return view_.template get_ptr<View>();
+  }
+
+  template <class View>
+  constexpr const View* target() const noexcept {
+    return const_cast<any_view&>(*this).template target<View>();
+  }
+
   constexpr void swap(any_view& other) noexcept {
     view_.swap(other.view_);
     std::swap(view_vtable_, other.view_vtable_);
+    end_cache_ = end_cache();
+    other.end_cache_ = end_cache();
   }
   constexpr friend void swap(any_view& x, any_view& y) noexcept { x.swap(y); }
 
  private:
-  template <class Iter>
-  static constexpr any_iterator_vtable iter_vtable =
-      iterator_vtable_gen::template generate<Iter>();
+  template <class View, class Fn>
+  constexpr bool for_each_if(Fn& fn) {
+    View* view = target<View>();
+    if (!view) {
+      return false;
+    }
+    for (auto&& elem : *view) {
+      std::invoke(fn, static_cast<Ref>(std::forward<decltype(elem)>(elem)));
+    }
+    return true;
+  }
 
   template <class Iter, class Sent>
-  static constexpr any_sentinel_vtable sent_vtable =
-      sentinel_vtable_gen::template generate<Iter, Sent>();
+  static constexpr any_cursor_vtable cursor_vtable =
+      cursor_vtable_gen::template generate<Iter, Sent>();
 
   template <class View>
   static constexpr any_view_vtable view_vtable =
       view_vtable_gen::template generate<View>();
 
+  // The end iterator of a common any_view, set by the first call to end().
+  // It refers to the view it was computed from, so it is dropped instead of
+  // being copied, moved or swapped along with the view
+  struct common_end_cache {
+    std::optional<any_iterator> end_;
+
+    constexpr common_end_cache() = default;
+    constexpr common_end_cache(const common_end_cache&) noexcept {}
+    constexpr common_end_cache& operator=(const common_end_cache&) noexcept {
+      end_.reset();
+      return *this;
+    }
+  };
+
+  struct no_end_cache {};
+
+  using end_cache = conditional_t<is_common, common_end_cache, no_end_cache>;
+
   const any_view_vtable* view_vtable_;
   view_storage view_;
+  [[no_unique_address]] end_cache end_cache_;
 };
 
 template <class Value, any_view_options Opts, class Ref, class RValueRef,
-          class Diff>
-inline constexpr bool
-    enable_borrowed_range<any_view<Value, Opts, Ref, RValueRef, Diff>> =
+          class Diff, class Policy>
+inline constexpr bool enable_borrowed_range<
+    any_view<Value, Opts, Ref, RValueRef, Diff, Policy>> =
         (Opts & any_view_options::borrowed) != any_view_options::none;
 
+// A non-owning reference to a range, with the iterators of the
+// corresponding any_view. It is two pointers and trivially copyable, and
+// the range must outlive it, e.g. as a function parameter:
+//   int algo(any_view_ref<std::string> strings);
+template <class Element, any_view_options Opts = any_view_options::input,
+          class Ref = Element&, class RValueRef = __rvalue_ref_t<Ref>,
+          class Diff = ptrdiff_t, class Policy = any_view_policy>
+class any_view_ref
+    : public view_interface<
+          any_view_ref<Element, Opts, Ref, RValueRef, Diff, Policy>> {
+  using any_view_type = any_view<Element, Opts, Ref, RValueRef, Diff, Policy>;
+  using allocator_type = typename any_view_type::allocator_type;
+  using size_type = std::__make_unsigned_t<Diff>;
+
+  static_assert(!any_view_type::is_indexed,
+                "the iterators of an indexed any_view refer to its storage");
+
+ public:
+  using iterator = typename any_view_type::iterator;
+  using sentinel = typename any_view_type::sentinel;
+
+  constexpr any_view_ref() noexcept
+      : view_(nullptr), vtable_(&empty_vtable) {}
+
+  // An any_view with the same parameters is not erased again: its iterators
+  // are returned as they are
+  template <class R>
+    requires(!std::same_as<remove_cv_t<R>, any_view_ref> &&
+             any_view_type::template range_options_constraint<R>())
+  constexpr any_view_ref(R& range) noexcept
+      : view_(const_cast<void*>(
+            static_cast<const void*>(std::addressof(range)))),
+        vtable_(&vtable<R>) {}
+
+  constexpr iterator begin() const { return (*(vtable_->begin_))(view_); }
+  constexpr sentinel end() const { return (*(vtable_->end_))(view_); }
+
+  constexpr size_type size() const
+    requires(any_view_type::is_sized)
+  {
+    return (*(vtable_->size_))(view_);
+  }
+
+  constexpr size_type reserve_hint() const
+    requires(any_view_type::is_approximately_sized)
+  {
+    if constexpr (any_view_type::is_sized) {
+      return size();
+    } else {
+      return (*(vtable_->reserve_hint_))(view_);
+    }
+  }
+
+ private:
+  struct sized_vtable {
+    size_type (*size_)(void*);
+  };
+
+  struct approximately_sized_vtable {
+    size_type (*reserve_hint_)(void*);
+  };
+
+  struct unsized {};
+
+  struct ref_vtable
+      : conditional_t<any_view_type::is_sized, sized_vtable,
+                      conditional_t<any_view_type::is_approximately_sized,
+                                    approximately_sized_vtable, unsized>> {
+    iterator (*begin_)(void*);
+    sentinel (*end_)(void*);
+  };
+
+  template <class R>
+  static constexpr R& get(void* view) {
+    return *static_cast<R*>(view);
+  }
+
+  template <class R>
+  static consteval ref_vtable generate() {
+    using gen = typename any_view_type::view_vtable_gen;
+    ref_vtable t;
+    t.begin_ = [](void* view) -> iterator {
+      if constexpr (std::same_as<remove_cv_t<R>, any_view_type>) {
+        return get<R>(view).begin();
+      } else {
+        return gen::begin_of(get<R>(view), allocator_type());
+      }
+    };
+    t.end_ = [](void* view) -> sentinel {
+      if constexpr (std::same_as<remove_cv_t<R>, any_view_type>) {
+        return get<R>(view).end();
+      } else {
+        return gen::end_of(get<R>(view), allocator_type());
+      }
+    };
+    if constexpr (any_view_type::is_sized) {
+      t.size_ = [](void* view) -> size_type {
+        return size_type(std::ranges::size(get<R>(view)));
+      };
+    } else if constexpr (any_view_type::is_approximately_sized) {
+      t.reserve_hint_ = [](void* view) -> size_type {
+        return size_type(std::ranges::reserve_hint(get<R>(view)));
+      };
+    }
+    return t;
+  }
+
+  static consteval ref_vtable generate_empty() {
+    using empty = typename any_view_type::empty_view_;
+    ref_vtable t;
+    t.begin_ = [](void*) -> iterator {
+      return empty::begin_of(allocator_type());
+    };
+    t.end_ = [](void*) -> sentinel { return empty::end_of(allocator_type()); };
+    if constexpr (any_view_type::is_sized) {
+      t.size_ = [](void*) -> size_type { return 0; };
+    } else if constexpr (any_view_type::is_approximately_sized) {
+      t.reserve_hint_ = [](void*) -> size_type { return 0; };
+    }
+    return t;
+  }
+
+  template <class R>
+  static constexpr ref_vtable vtable = generate<R>();
+
+  static constexpr ref_vtable empty_vtable = generate_empty();
+
+  void* view_;
+  const ref_vtable* vtable_;
+};
+
+template <class Value, any_view_options Opts, class Ref, class RValueRef,
+          class Diff, class Policy>
+inline constexpr bool enable_borrowed_range<
+    any_view_ref<Value, Opts, Ref, RValueRef, Diff, Policy>> = true;
+
+namespace pmr {
+
+// any_view whose heap allocations come from a std::pmr::memory_resource:
+//   pmr::any_view<int> v(std::allocator_arg, &arena, range);
+struct any_view_policy : ranges::any_view_policy {
+  using allocator_type = detail::resource_allocator<std::byte>;
+};
+
+template <class Element, any_view_options Opts = any_view_options::input,
+          class Ref = Element&, class RValueRef = __rvalue_ref_t<Ref>,
+          class Diff = ptrdiff_t>
+using any_view =
+    ranges::any_view<Element, Opts, Ref, RValueRef, Diff, any_view_policy>;
+
+}  // namespace pmr
+
 }  // namespace std::ranges
 
 #endif
@@ -0,0 +1,315 @@
+#ifndef LIBCPP__RANGE_ANY_VIEW_INSTRUMENTATION_HPP
+#define LIBCPP__RANGE_ANY_VIEW_INSTRUMENTATION_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "instrumentation.hpp"
+
+namespace std::ranges {
+
+// Counts the erased calls per erased type and per call site, in per-thread
+// counters that the owning thread updates without read-modify-write
+// operations and that any thread can read. The erased calls do not know
+// where they are made from: a call site is marked by a `scope`, and the
+// events of a thread are counted under its innermost scope, or under no
+// site outside of any scope. One in `sample_period` increments is timed
+// until the next increment of the same type at the same site on the same
+// thread, which is the latency of one loop iteration. To enable it:
+//   struct counted_policy : any_view_policy {
+//     using instrumentation = any_view_instrumentation;
+//   };
+//   any_view_instrumentation::scope site;  // counts under this line
+// The counters of a thread are kept after the thread exits, so that they
+// are part of the dump, and a new thread takes them over: there are as many
+// as the most threads that recorded events at the same time. The events
+// recorded by a thread after it gave its counters back, from the destructors
+// of thread_locals, are not counted
+struct any_view_instrumentation {
+  static constexpr bool enabled = true;
+  static constexpr uint64_t sample_period = 1024;
+
+  // Marks the events of this thread until it is destroyed as made from site
+  class scope {
+   public:
+    explicit scope(
+        std::source_location site = std::source_location::current()) noexcept
+        : prev_(current_site_) {
+      current_site_ = site;
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    ~scope() { current_site_ = prev_; }
+
+   private:
+    std::source_location prev_;
+  };
+
+  template <class T>
+  static void record(any_view_event e) noexcept {
+    // the destructors of thread_locals that run after the counters were
+    // given back, which another thread may have taken over
+    if (released_) return;
+    counters& c = counters_of<T>();
+    c.add(static_cast<size_t>(e));
+    if (e == any_view_event::increment) {
+      c.sample_iteration();
+    }
+  }
+
+  // The number of events of type T, over all the threads and sites
+  template <class T>
+  static uint64_t count(any_view_event e) noexcept {
+    uint64_t n = 0;
+    for_each_counters([&](const counters& c) {
+      if (c.key_ == &key<T>) {
+        n += c.counts_[static_cast<size_t>(e)].load(memory_order_relaxed);
+      }
+    });
+    return n;
+  }
+
+  // The number of events of type T made from site, over all the threads
+  template <class T>
+  static uint64_t count(any_view_event e,
+                        const std::source_location& site) noexcept {
+    uint64_t n = 0;
+    for_each_counters([&](const counters& c) {
+      if (c.key_ == &key<T> && same_site(c.site_, site)) {
+        n += c.counts_[static_cast<size_t>(e)].load(memory_order_relaxed);
+      }
+    });
+    return n;
+  }
+
+  // {"types": [{"type": "...", "site": "file:line:column", "deref": n, ...,
+  //             "latency_samples": n, "latency_ns": n}, ...]}, summed over
+  // all the threads. The site is empty for the events made outside of any
+  // scope
+  static void dump_json(std::ostream& os) {
+    struct totals {
+      const void* key_;
+      std::string_view name_;
+      std::source_location site_;
+      std::array<uint64_t, __any_view_event_count> counts_{};
+      uint64_t latency_samples_ = 0;
+      uint64_t latency_ns_ = 0;
+    };
+    std::vector<totals> types;
+    for_each_counters([&](const counters& c) {
+      auto it = types.begin();
+      while (it != types.end() &&
+             (it->key_ != c.key_ || !same_site(it->site_, c.site_))) {
+        ++it;
+      }
+      if (it == types.end()) {
+        it = types.insert(it, totals{c.key_, c.name_, c.site_});
+      }
+      for (size_t i = 0; i != __any_view_event_count; ++i) {
+        it->counts_[i] += c.counts_[i].load(memory_order_relaxed);
+      }
+      it->latency_samples_ += c.latency_samples_.load(memory_order_relaxed);
+      it->latency_ns_ += c.latency_ns_.load(memory_order_relaxed);
+    });
+
+    auto quoted = [&](std::string_view str) {
+      os << '"';
+      for (char ch : str) {
+        if (ch == '"' || ch == '\\') os << '\\';
+        os << ch;
+      }
+      os << '"';
+    };
+    os << "{\"types\": [";
+    for (size_t t = 0; t != types.size(); ++t) {
+      os << (t == 0 ? "" : ", ") << "{\"type\": ";
+      quoted(types[t].name_);
+      os << ", \"site\": ";
+      const std::source_location& site = types[t].site_;
+      if (site.line() == 0) {
+        quoted("");
+      } else {
+        quoted(std::string(site.file_name()) + ':' +
+               std::to_string(site.line()) + ':' +
+               std::to_string(site.column()));
+      }
+      for (size_t i = 0; i != __any_view_event_count; ++i) {
+        os << ", \"" << event_names[i] << "\": " << types[t].counts_[i];
+      }
+      os << ", \"latency_samples\": " << types[t].latency_samples_
+         << ", \"latency_ns\": " << types[t].latency_ns_ << '}';
+    }
+    os << "]}";
+  }
+
+ private:
+  static constexpr std::array<const char*, __any_view_event_count>
+      event_names = {
+          "deref",
+          "iter_move",
+          "increment",
+          "decrement",
+          "equal",
+          "advance",
+          "distance_to",
+          "begin",
+          "end",
+          "heap_allocation",
+          "copy",
+      };
+
+  template <class T>
+  static constexpr char key = 0;
+
+  // the innermost scope of this thread, a default-constructed one, whose
+  // line is 0, outside of any scope
+  static inline thread_local std::source_location current_site_{};
+
+  static bool same_site(const std::source_location& x,
+                        const std::source_location& y) noexcept {
+    return x.line() == y.line() && x.column() == y.column() &&
+           (x.file_name() == y.file_name() ||
+            std::string_view(x.file_name()) == y.file_name());
+  }
+
+  template <class T>
+  static std::string_view type_name() {
+    std::string_view name = std::source_location::current().function_name();
+    auto first = name.find("T = ");
+    if (first == std::string_view::npos) return name;
+    name.remove_prefix(first + 4);
+    return name.substr(0, name.find_first_of(";]"));
+  }
+
+  // written by the owning thread only, read by any thread
+  struct counters {
+    const void* key_;
+    std::string_view name_;
+    std::source_location site_;
+    std::array<std::atomic<uint64_t>, __any_view_event_count> counts_{};
+    std::atomic<uint64_t> latency_samples_ = 0;
+    std::atomic<uint64_t> latency_ns_ = 0;
+    counters* next_ = nullptr;
+
+    // owning thread only
+    uint64_t until_sample_ = sample_period;
+    bool sampling_ = false;
+    std::chrono::steady_clock::time_point sample_start_{};
+
+    static void bump(std::atomic<uint64_t>& n, uint64_t d) noexcept {
+      n.store(n.load(memory_order_relaxed) + d, memory_order_relaxed);
+    }
+
+    void add(size_t e) noexcept { bump(counts_[e], 1); }
+
+    void sample_iteration() noexcept {
+      if (sampling_) {
+        auto elapsed = std::chrono::steady_clock::now() - sample_start_;
+        bump(latency_ns_, uint64_t(std::chrono::duration_cast<
+                                       std::chrono::nanoseconds>(elapsed)
+                                       .count()));
+        bump(latency_samples_, 1);
+        sampling_ = false;
+      } else if (--until_sample_ == 0) {
+        until_sample_ = sample_period;
+        sampling_ = true;
+        sample_start_ = std::chrono::steady_clock::now();
+      }
+    }
+  };
+
+  struct thread_counters {
+    std::atomic<counters*> head_ = nullptr;
+    thread_counters* next_ = nullptr;
+    // owned by a running thread
+    std::atomic<bool> in_use_ = true;
+  };
+
+  static inline std::atomic<thread_counters*> threads_ = nullptr;
+
+  // the counters of an exited thread if there are some, new ones otherwise
+  static thread_counters* claim() {
+    for (auto* t = threads_.load(memory_order_acquire); t; t = t->next_) {
+      if (!t->in_use_.load(memory_order_relaxed) &&
+          !t->in_use_.exchange(true, memory_order_acquire)) {
+        // the samples of the previous thread are not finished
+        for (auto* c = t->head_.load(memory_order_relaxed); c; c = c->next_) {
+          c->sampling_ = false;
+        }
+        return t;
+      }
+    }
+    auto* t = new thread_counters;
+    t->next_ = threads_.load(memory_order_relaxed);
+    while (!threads_.compare_exchange_weak(t->next_, t, memory_order_release,
+                                           memory_order_relaxed)) {
+    }
+    return t;
+  }
+
+  // set once the thread gave its counters back. It is trivially
+  // destructible, so it can be read until the thread is gone
+  static inline thread_local bool released_ = false;
+
+  // gives the counters back when the thread exits
+  struct thread_owner {
+    thread_counters* t_;
+    ~thread_owner() {
+      released_ = true;
+      t_->in_use_.store(false, memory_order_release);
+    }
+  };
+
+  static thread_counters& this_thread() {
+    thread_local thread_owner owner{claim()};
+    return *owner.t_;
+  }
+
+  // the counters of the last site are cached, which is the one of every
+  // call in a loop
+  template <class T>
+  static counters& counters_of() {
+    thread_local counters* self = nullptr;
+    const std::source_location& site = current_site_;
+    if (self && self->site_.line() == site.line() &&
+        self->site_.column() == site.column() &&
+        self->site_.file_name() == site.file_name()) {
+      return *self;
+    }
+    thread_counters& t = this_thread();
+    for (auto* c = t.head_.load(memory_order_relaxed); c; c = c->next_) {
+      if (c->key_ == &key<T> && same_site(c->site_, site)) {
+        self = c;
+        return *c;
+      }
+    }
+    auto* c = new counters{&key<T>, type_name<T>(), site};
+    c->next_ = t.head_.load(memory_order_relaxed);
+    t.head_.store(c, memory_order_release);
+    self = c;
+    return *c;
+  }
+
+  template <class Fn>
+  static void for_each_counters(Fn fn) {
+    for (auto* t = threads_.load(memory_order_acquire); t; t = t->next_) {
+      for (auto* c = t->head_.load(memory_order_acquire); c; c = c->next_) {
+        fn(*c);
+      }
+    }
+  }
+};
+
+}  // namespace std::ranges
+
+#endif
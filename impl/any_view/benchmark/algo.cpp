@@ -22,4 +22,25 @@ int algo2(std::ranges::any_view<std::string> strings)
   }
   return result;
 }
+
+int algo2_cursor(std::ranges::any_view<std::string> strings) {
+  int result = 0;
+  auto cursor = strings.cursor();
+  while (const auto* str = cursor.next()) {
+    if (str->size() > 6) {
+      result += str->size();
+    }
+  }
+  return result;
+}
+
+int algo2_ref(std::ranges::any_view_ref<std::string> strings) {
+  int result = 0;
+  for (const auto& str : strings) {
+    if (str.size() > 6) {
+      result += str.size();
+    }
+  }
+  return result;
+}
 }  // namespace lib
\ No newline at end of file
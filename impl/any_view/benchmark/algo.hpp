@@ -8,5 +8,7 @@ namespace lib {
 
 int algo1(const std::vector<std::string>& strings);
 int algo2(std::ranges::any_view<std::string> strings);
+int algo2_cursor(std::ranges::any_view<std::string> strings);
+int algo2_ref(std::ranges::any_view_ref<std::string> strings);
 
 }
\ No newline at end of file
@@ -93,6 +93,17 @@ static void BM_algo_AnyView(benchmark::State& state) {
 // Register the function as a benchmark
 BENCHMARK(BM_algo_AnyView)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
 
+static void BM_algo_AnyViewRef(benchmark::State& state) {
+  UI ui{global_widgets | std::views::take(state.range(0)) |
+        std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    auto names = ui.widgets_ | std::views::transform(&Widget::name);
+    auto res = lib::algo2_ref(names);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(BM_algo_AnyViewRef)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
 /*
 Benchmark                                                     Time             CPU      Time Old      Time New       CPU Old       CPU New
 ------------------------------------------------------------------------------------------------------------------------------------------
@@ -141,6 +152,36 @@ static void BM_2algo_AnyView(benchmark::State& state) {
 // Register the function as a benchmark
 BENCHMARK(BM_2algo_AnyView)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
 
+static void BM_2algo_AnyViewCursor(benchmark::State& state) {
+  UI ui{global_widgets | std::views::take(state.range(0)) |
+               std::ranges::to<std::vector>()};
+  std::vector<std::string> widget_names;
+  widget_names.reserve(ui.widgets_.size());
+  for(const auto& widget : ui.widgets_) {
+    widget_names.push_back(widget.name);
+  }
+  for (auto _ : state) {
+    auto res = lib::algo2_cursor(std::views::all(widget_names));
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(BM_2algo_AnyViewCursor)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_2algo_AnyViewRef(benchmark::State& state) {
+  UI ui{global_widgets | std::views::take(state.range(0)) |
+        std::ranges::to<std::vector>()};
+  std::vector<std::string> widget_names;
+  widget_names.reserve(ui.widgets_.size());
+  for (const auto& widget : ui.widgets_) {
+    widget_names.push_back(widget.name);
+  }
+  for (auto _ : state) {
+    auto res = lib::algo2_ref(widget_names);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(BM_2algo_AnyViewRef)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
 /*
 Benchmark                                                       Time             CPU      Time Old      Time New       CPU Old       CPU New
 --------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "any_async_view.hpp"
+#include "any_view.hpp"
+#include "producer_view.hpp"
+
+// Reading a file in chunks: an any_async_view over fd_chunks, driven by a
+// coroutine, against a blocking any_view over the same reads
+
+namespace {
+
+using Chunk = std::span<const std::byte>;
+using AsyncChunks =
+    std::ranges::any_async_view<Chunk, std::ranges::any_view_options::input,
+                                Chunk>;
+
+struct TempFile {
+  std::FILE* f = std::tmpfile();
+
+  explicit TempFile(size_t size) {
+    std::vector<std::byte> data(size, std::byte{1});
+    std::fwrite(data.data(), 1, data.size(), f);
+    std::fflush(f);
+  }
+  ~TempFile() { std::fclose(f); }
+
+  int rewind() {
+    int fd = ::fileno(f);
+    ::lseek(fd, 0, SEEK_SET);
+    return fd;
+  }
+};
+
+// the coroutine completes before it returns, the file has data
+struct eager {
+  struct promise_type {
+    eager get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { throw; }
+  };
+};
+
+eager consume(AsyncChunks& v, size_t& bytes) {
+  for (auto it = co_await v.begin(); it != v.end(); co_await ++it) {
+    bytes += (*it).size();
+  }
+}
+
+struct ReadChunk {
+  int fd;
+  std::vector<std::byte> buf;
+
+  std::optional<Chunk> operator()() {
+    auto n = ::read(fd, buf.data(), buf.size());
+    if (n <= 0) return std::nullopt;
+    return Chunk(buf.data(), size_t(n));
+  }
+};
+
+}  // namespace
+
+static void BM_AnyAsyncViewFile(benchmark::State& state) {
+  TempFile file(size_t(state.range(0)));
+  for (auto _ : state) {
+    AsyncChunks v(std::ranges::fd_chunks(file.rewind(), 4096));
+    size_t bytes = 0;
+    consume(v, bytes);
+    benchmark::DoNotOptimize(bytes);
+  }
+}
+BENCHMARK(BM_AnyAsyncViewFile)->RangeMultiplier(4)->Range(1 << 14, 1 << 22);
+
+static void BM_AnyViewFileBlocking(benchmark::State& state) {
+  TempFile file(size_t(state.range(0)));
+  for (auto _ : state) {
+    std::ranges::any_view<Chunk, std::ranges::any_view_options::input, Chunk&>
+        v(std::ranges::producer_view<ReadChunk, 1>(
+            ReadChunk{file.rewind(), std::vector<std::byte>(4096)}));
+    size_t bytes = 0;
+    for (Chunk c : v) {
+      bytes += c.size();
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+}
+BENCHMARK(BM_AnyViewFileBlocking)->RangeMultiplier(4)->Range(1 << 14, 1 << 22);
@@ -1,9 +1,13 @@
 #include <benchmark/benchmark.h>
 
+#include <array>
+#include <numeric>
 #include <ranges>
 #include <vector>
 
 #include "any_view.hpp"
+#include "any_view_instrumentation.hpp"
+#include "parallel.hpp"
 
 static void BM_vector(benchmark::State& state) {
   std::vector v =
@@ -29,3 +33,239 @@ static void BM_AnyView(benchmark::State& state) {
   }
 }
 BENCHMARK(BM_AnyView)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewContiguous(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::contiguous> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewContiguous)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewBatch(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> av(
+      std::views::all(v));
+  std::array<int*, 64> buf;
+  for (auto _ : state) {
+    auto it = av.begin();
+    auto last = av.end();
+    while (auto n = it.next_batch(buf, last)) {
+      for (size_t i = 0; i != n; ++i) {
+        benchmark::DoNotOptimize(*buf[i]);
+      }
+    }
+  }
+}
+BENCHMARK(BM_AnyViewBatch)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// iterator copies: operator++(int) and operator+ copy the erased iterator,
+// which is trivially copyable here
+static void BM_AnyViewIteratorCopy(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::random_access> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    auto last = av.end();
+    for (auto it = av.begin(); it != last;) {
+      benchmark::DoNotOptimize(*(it + 0));
+      it++;
+    }
+  }
+}
+BENCHMARK(BM_AnyViewIteratorCopy)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+template <std::ranges::any_view_options Opts>
+static void BM_AnyViewSort(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) |
+      std::views::transform([](int i) { return (i * 7919) % 1031; }) |
+      std::ranges::to<std::vector>();
+  std::vector<int> work;
+  for (auto _ : state) {
+    work = v;
+    std::ranges::any_view<int, Opts> av(std::views::all(work));
+    std::ranges::sort(av);
+    benchmark::DoNotOptimize(work.data());
+  }
+}
+BENCHMARK_TEMPLATE(BM_AnyViewSort,
+                   std::ranges::any_view_options::random_access |
+                       std::ranges::any_view_options::sized)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AnyViewSort,
+                   std::ranges::any_view_options::random_access |
+                       std::ranges::any_view_options::sized |
+                       std::ranges::any_view_options::indexed)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewCounted(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                 std::ranges::any_view_options::sized |
+                                 std::ranges::any_view_options::counted>
+      av(std::views::all(v));
+  for (auto _ : state) {
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewCounted)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// an unbounded view: the end test against unreachable_sentinel_t is not an
+// indirect call
+static void BM_AnyViewUnreachable(benchmark::State& state) {
+  std::ranges::any_view<int, std::ranges::any_view_options::forward, int, int>
+      av(std::views::iota(0));
+  for (auto _ : state) {
+    auto last = av.end();
+    int n = 0;
+    for (auto it = av.begin(); it != last && n != state.range(0); ++it, ++n) {
+      benchmark::DoNotOptimize(*it);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewUnreachable)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// BM_AnyView with the counting instrumentation, to measure its overhead
+struct InstrumentedPolicy : std::ranges::any_view_policy {
+  using instrumentation = std::ranges::any_view_instrumentation;
+};
+
+static void BM_AnyViewInstrumented(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::input, int&, int&&,
+                        std::ptrdiff_t, InstrumentedPolicy>
+      av(std::views::all(v));
+  for (auto _ : state) {
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewInstrumented)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// branch once into a typed loop over the erased view
+static void BM_AnyViewTarget(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int> av(std::views::all(v));
+  for (auto _ : state) {
+    auto* r = av.target<std::ranges::ref_view<std::vector<int>>>();
+    for (auto i : *r) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewTarget)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// the erased view is split across threads, without copying it to a vector
+static void BM_AnyViewParallelReduce(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                 std::ranges::any_view_options::sized>
+      av(std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::ranges::parallel_reduce(av, 0L, std::plus{}));
+  }
+}
+BENCHMARK(BM_AnyViewParallelReduce)
+    ->RangeMultiplier(4)
+    ->Range(1 << 14, 1 << 22)
+    ->UseRealTime();
+
+// an iterator-pair algorithm: views::common wraps the erased iterator in a
+// common_iterator, the common option hands over the erased end
+static void BM_AnyViewViewsCommon(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                 std::ranges::any_view_options::copyable>
+      av(std::views::all(v));
+  for (auto _ : state) {
+    auto c = av | std::views::common;
+    benchmark::DoNotOptimize(std::accumulate(c.begin(), c.end(), 0L));
+  }
+}
+BENCHMARK(BM_AnyViewViewsCommon)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewCommon(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) | std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                 std::ranges::any_view_options::common>
+      av(std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(av.begin(), av.end(), 0L));
+  }
+}
+BENCHMARK(BM_AnyViewCommon)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+// counting through the erased iterator, and with the erased algorithm whose
+// loop over the ints is vectorized
+static void BM_AnyViewRangesCount(benchmark::State& state) {
+  std::vector v = std::views::iota(0, state.range(0)) |
+                  std::views::transform([](int i) { return i % 7; }) |
+                  std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::ranges::count(av, 3));
+  }
+}
+BENCHMARK(BM_AnyViewRangesCount)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewCountSlot(benchmark::State& state) {
+  std::vector v = std::views::iota(0, state.range(0)) |
+                  std::views::transform([](int i) { return i % 7; }) |
+                  std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(av.count(3));
+  }
+}
+BENCHMARK(BM_AnyViewCountSlot)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewMaxElementSlot(benchmark::State& state) {
+  std::vector v =
+      std::views::iota(0, state.range(0)) |
+      std::views::transform([](int i) { return (i * 7919) % 1031; }) |
+      std::ranges::to<std::vector>();
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(*av.max_element());
+  }
+}
+BENCHMARK(BM_AnyViewMaxElementSlot)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewAccumulateSlot(benchmark::State& state) {
+  std::vector v = std::views::iota(0, state.range(0)) |
+                  std::views::transform([](int i) { return i * 0.5; }) |
+                  std::ranges::to<std::vector>();
+  std::ranges::any_view<double, std::ranges::any_view_options::forward> av(
+      std::views::all(v));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(av.accumulate());
+  }
+}
+BENCHMARK(BM_AnyViewAccumulateSlot)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
@@ -68,6 +68,31 @@ static void BM_AnyViewPipeline(benchmark::State& state) {
 }
 BENCHMARK(BM_AnyViewPipeline)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
 
+static void BM_AnyViewPipelineForEach(benchmark::State& state) {
+  lib::UI1 ui1{global_widgets | std::views::take(state.range(0)) |
+               std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    ui1.getWidgetNames().for_each([](std::string& name) {
+      benchmark::DoNotOptimize(name);
+    });
+  }
+}
+BENCHMARK(BM_AnyViewPipelineForEach)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewPipelineForEachExpected(benchmark::State& state) {
+  lib::UI1B ui1{global_widgets | std::views::take(state.range(0)) |
+                std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    ui1.getWidgetNames().for_each<lib::UI1B::Pipeline>(
+        [](std::string& name) { benchmark::DoNotOptimize(name); });
+  }
+}
+BENCHMARK(BM_AnyViewPipelineForEachExpected)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
 static void BM_RawPipeline(benchmark::State& state) {
   lib::UI2 ui2{global_widgets | std::views::take(state.range(0)) |
                std::ranges::to<std::vector>()};
@@ -116,6 +141,43 @@ static void BM_VectorCopyRanges(benchmark::State& state) {
 // Register the function as a benchmark
 BENCHMARK(BM_VectorCopyRanges)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
 
+static void BM_AnyViewVectorCopy(benchmark::State& state) {
+  lib::UI3Any ui3{global_widgets | std::views::take(state.range(0)) |
+                  std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    for (const auto& name : ui3.getWidgetNames()) {
+      benchmark::DoNotOptimize(const_cast<std::string&>(name));
+    }
+  }
+}
+BENCHMARK(BM_AnyViewVectorCopy)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewVectorCopyReserve(benchmark::State& state) {
+  lib::UI3BAny ui3b{global_widgets | std::views::take(state.range(0)) |
+                    std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    for (const auto& name : ui3b.getWidgetNames()) {
+      benchmark::DoNotOptimize(const_cast<std::string&>(name));
+    }
+  }
+}
+BENCHMARK(BM_AnyViewVectorCopyReserve)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewVectorCopyRanges(benchmark::State& state) {
+  lib::UI3CAny ui3c{global_widgets | std::views::take(state.range(0)) |
+                    std::ranges::to<std::vector>()};
+  for (auto _ : state) {
+    for (const auto& name : ui3c.getWidgetNames()) {
+      benchmark::DoNotOptimize(const_cast<std::string&>(name));
+    }
+  }
+}
+BENCHMARK(BM_AnyViewVectorCopyRanges)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
 static void BM_VectorRefWrapper(benchmark::State& state) {
   lib::UI4 ui4{global_widgets | std::views::take(state.range(0)) |
                std::ranges::to<std::vector>()};
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <ranges>
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+#include "any_view.hpp"
+#include "producer_view.hpp"
+
+// A streaming source of ints: a plain std::generator loop, the generator
+// erased in an any_view, and the same read ahead in batches
+
+namespace {
+
+struct Source {
+  long n;
+  long i = 0;
+
+  std::optional<long> operator()() {
+    if (i == n) return std::nullopt;
+    return i++;
+  }
+};
+
+}  // namespace
+
+static void BM_ProducerView(benchmark::State& state) {
+  for (auto _ : state) {
+    std::ranges::any_view<long> av(
+        std::ranges::producer_view(Source{state.range(0)}));
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_ProducerView)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+#if __cpp_lib_generator >= 202207L
+
+static std::generator<long> iota(long n) {
+  for (long i = 0; i != n; ++i) {
+    co_yield i;
+  }
+}
+
+static void BM_Generator(benchmark::State& state) {
+  for (auto _ : state) {
+    for (auto i : iota(state.range(0))) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_Generator)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewGenerator(benchmark::State& state) {
+  for (auto _ : state) {
+    // the reference of std::generator<long> is long&&
+    std::ranges::any_view<const long> av(iota(state.range(0)));
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewGenerator)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_AnyViewGeneratorReadAhead(benchmark::State& state) {
+  for (auto _ : state) {
+    std::ranges::any_view<long> av(
+        std::ranges::read_ahead(iota(state.range(0))));
+    for (auto i : av) {
+      benchmark::DoNotOptimize(i);
+    }
+  }
+}
+BENCHMARK(BM_AnyViewGeneratorReadAhead)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
+
+#endif
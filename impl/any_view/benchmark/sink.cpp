@@ -0,0 +1,37 @@
+#include "sink.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace lib {
+
+void squares(int n, std::vector<int>& out) {
+  out.reserve(out.size() + n);
+  for (int i = 0; i != n; ++i) {
+    out.push_back(i * i);
+  }
+}
+
+void squares_sink(int n, std::ranges::any_output_range<int> out) {
+  out.reserve(n);
+  for (int i = 0; i != n; ++i) {
+    out.push(i * i);
+  }
+}
+
+void squares_sink_batch(int n, std::ranges::any_output_range<int> out) {
+  out.reserve(n);
+  std::array<int, 256> batch;
+  size_t size = 0;
+  for (int i = 0; i != n; ++i) {
+    batch[size++] = i * i;
+    if (size == batch.size()) {
+      out.push_batch(batch);
+      size = 0;
+    }
+  }
+  out.push_batch(std::span(batch.data(), size));
+}
+
+}  // namespace lib
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+#include "any_output_range.hpp"
+
+namespace lib {
+
+// the squares of [0, n), written by a library function to a vector, or to
+// an erased sink one value or one batch at a time
+void squares(int n, std::vector<int>& out);
+void squares_sink(int n, std::ranges::any_output_range<int> out);
+void squares_sink_batch(int n, std::ranges::any_output_range<int> out);
+
+}  // namespace lib
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "any_output_range.hpp"
+#include "sink.hpp"
+
+// A library function in another translation unit writes its results to a
+// std::vector&, or to an any_output_range over the same vector
+
+static void BM_SinkVector(benchmark::State& state) {
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    lib::squares(state.range(0), out);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_SinkVector)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_SinkAnyOutputRange(benchmark::State& state) {
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    lib::squares_sink(state.range(0), out);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_SinkAnyOutputRange)->RangeMultiplier(2)->Range(1 << 10, 1 << 18);
+
+static void BM_SinkAnyOutputRangeBatch(benchmark::State& state) {
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    lib::squares_sink_batch(state.range(0), out);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_SinkAnyOutputRangeBatch)
+    ->RangeMultiplier(2)
+    ->Range(1 << 10, 1 << 18);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <ranges>
+#include <vector>
+
+#include "any_view.hpp"
+
+// Heap vs small buffer: begin() and a copy of an erased iterator whose
+// underlying iterator is `Size` bytes, with the default policy (3 words of
+// buffer) and with a policy whose buffer is large enough for all sizes.
+
+namespace {
+
+struct LargeBuffers : std::ranges::any_view_policy {
+  static constexpr size_t iterator_buffer_size = 16 * sizeof(void*);
+};
+
+template <size_t Size>
+struct PaddedIter {
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  int* p = nullptr;
+  std::array<char, Size - sizeof(int*)> state{};
+
+  int& operator*() const { return *p; }
+  PaddedIter& operator++() {
+    ++p;
+    return *this;
+  }
+  PaddedIter operator++(int) {
+    auto tmp = *this;
+    ++p;
+    return tmp;
+  }
+  friend bool operator==(const PaddedIter& x, const PaddedIter& y) {
+    return x.p == y.p;
+  }
+};
+
+}  // namespace
+
+template <size_t Size, class Policy>
+static void BM_IteratorStorage(benchmark::State& state) {
+  std::vector<int> v(16, 1);
+  using Iter = PaddedIter<Size>;
+  std::ranges::any_view<int, std::ranges::any_view_options::forward, int&,
+                        int&&, std::ptrdiff_t, Policy>
+      av(std::ranges::subrange(Iter{v.data()}, Iter{v.data() + v.size()}));
+  for (auto _ : state) {
+    auto it = av.begin();
+    auto copy = it;
+    benchmark::DoNotOptimize(*copy);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 8, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 8, LargeBuffers);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 16, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 16, LargeBuffers);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 24, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 24, LargeBuffers);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 32, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 32, LargeBuffers);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 64, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 64, LargeBuffers);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 128, std::ranges::any_view_policy);
+BENCHMARK_TEMPLATE(BM_IteratorStorage, 128, LargeBuffers);
+
+// Heap fallback from a request-scoped arena instead of the global heap
+template <size_t Size>
+static void BM_IteratorStorageArena(benchmark::State& state) {
+  std::vector<int> v(16, 1);
+  using Iter = PaddedIter<Size>;
+  std::array<std::byte, 1 << 16> buffer;
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    std::ranges::pmr::any_view<int, std::ranges::any_view_options::forward>
+        av(std::allocator_arg, &arena,
+           std::ranges::subrange(Iter{v.data()}, Iter{v.data() + v.size()}));
+    auto it = av.begin();
+    auto copy = it;
+    benchmark::DoNotOptimize(*copy);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_IteratorStorageArena, 32);
+BENCHMARK_TEMPLATE(BM_IteratorStorageArena, 64);
+BENCHMARK_TEMPLATE(BM_IteratorStorageArena, 128);
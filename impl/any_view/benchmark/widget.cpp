@@ -28,6 +28,11 @@ UI2::getWidgetNames() {
          std::views::transform(UI2::TransformFn{});
 }
 
+std::ranges::any_view<std::string> UI1B::getWidgetNames() {
+  return widgets_ | std::views::filter(UI2::FilterFn{}) |
+         std::views::transform(UI2::TransformFn{});
+}
+
 std::vector<std::string> UI3::getWidgetNames() const {
   std::vector<std::string> results;
   // todo reserve? but how many?
@@ -56,6 +61,35 @@ std::vector<std::string> UI3C::getWidgetNames() const {
          std::views::transform(&Widget::name) | std::ranges::to<std::vector>();
 }
 
+std::ranges::any_view<const std::string> bigWidgetNames(
+    const std::vector<Widget>& widgets) {
+  return widgets |
+         std::views::filter([](const Widget& w) { return w.size > 10; }) |
+         std::views::transform(&Widget::name);
+}
+
+// element by element, through the erased iterator
+std::vector<std::string> UI3Any::getWidgetNames() const {
+  std::vector<std::string> results;
+  for (const std::string& name : bigWidgetNames(widgets_)) {
+    results.push_back(name);
+  }
+  return results;
+}
+
+// the copy loop runs inside the erased type
+std::vector<std::string> UI3BAny::getWidgetNames() const {
+  std::vector<std::string> results;
+  results.reserve(widgets_.size());
+  bigWidgetNames(widgets_).append_to(results);
+  return results;
+}
+
+// ranges::to constructs the vector from the any_view, which calls append_to
+std::vector<std::string> UI3CAny::getWidgetNames() const {
+  return bigWidgetNames(widgets_) | std::ranges::to<std::vector>();
+}
+
 std::vector<std::reference_wrapper<const std::string>> UI4::getWidgetNames()
     const {
   return widgets_ | std::views::filter([](const Widget& widget) {
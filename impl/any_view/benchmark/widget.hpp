@@ -2,6 +2,7 @@
 
 #include <ranges>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "any_view.hpp"
@@ -36,6 +37,16 @@ struct UI2 {
   getWidgetNames();
 };
 
+// UI1 with UI2's pipeline: callers can name the erased type and pass it to
+// any_view::for_each as an expected type
+struct UI1B {
+  std::vector<Widget> widgets_;
+
+  using Pipeline = decltype(std::declval<UI2&>().getWidgetNames());
+
+  std::ranges::any_view<std::string> getWidgetNames();
+};
+
 struct UI3 {
   std::vector<Widget> widgets_;
 
@@ -54,6 +65,29 @@ struct UI3C {
   std::vector<std::string> getWidgetNames() const;
 };
 
+// the names of the widgets with size > 10, erased
+std::ranges::any_view<const std::string> bigWidgetNames(
+    const std::vector<Widget>& widgets);
+
+// UI3, UI3B and UI3C with the names coming out of bigWidgetNames
+struct UI3Any {
+  std::vector<Widget> widgets_;
+
+  std::vector<std::string> getWidgetNames() const;
+};
+
+struct UI3BAny {
+  std::vector<Widget> widgets_;
+
+  std::vector<std::string> getWidgetNames() const;
+};
+
+struct UI3CAny {
+  std::vector<Widget> widgets_;
+
+  std::vector<std::string> getWidgetNames() const;
+};
+
 
 struct UI4 {
   std::vector<Widget> widgets_;
@@ -0,0 +1,94 @@
+#ifndef LIBCPP__RANGE_CONTIGUOUS_ALGORITHM_HPP
+#define LIBCPP__RANGE_CONTIGUOUS_ALGORITHM_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+namespace std::ranges::detail {
+
+// Loops over arrays of arithmetic values, written so that compilers
+// vectorize them: a block is scanned without an early exit and without a
+// branch on the values. They give the same results as the corresponding
+// std algorithms
+
+inline constexpr size_t simd_block = 16;
+
+// the index of the first element equal to value, n if there is none
+template <class T>
+constexpr size_t find(const T* p, size_t n, T value) {
+  size_t i = 0;
+  for (; i + simd_block <= n; i += simd_block) {
+    bool found = false;
+    for (size_t j = 0; j != simd_block; ++j) {
+      found |= p[i + j] == value;
+    }
+    if (found) break;
+  }
+  for (; i != n; ++i) {
+    if (p[i] == value) break;
+  }
+  return i;
+}
+
+template <class T>
+constexpr size_t count(const T* p, size_t n, T value) {
+  size_t c = 0;
+  for (size_t i = 0; i != n; ++i) {
+    c += p[i] == value;
+  }
+  return c;
+}
+
+// The sum is in order: floating point additions are not reassociated, so
+// only integer sums are vectorized
+template <class T>
+constexpr T accumulate(const T* p, size_t n, T init) {
+  for (size_t i = 0; i != n; ++i) {
+    init = init + p[i];
+  }
+  return init;
+}
+
+// The index of the first smallest element. Integers are reduced to the
+// smallest value, which vectorizes, and then searched for. Floating point
+// values are compared in order, as NaN is not equal to itself
+template <class T>
+constexpr size_t min_element(const T* p, size_t n) {
+  if (n == 0) return 0;
+  if constexpr (is_integral_v<T>) {
+    T m = p[0];
+    for (size_t i = 1; i != n; ++i) {
+      m = p[i] < m ? p[i] : m;
+    }
+    return detail::find(p, n, m);
+  } else {
+    size_t best = 0;
+    for (size_t i = 1; i != n; ++i) {
+      if (p[i] < p[best]) best = i;
+    }
+    return best;
+  }
+}
+
+// the index of the first largest element
+template <class T>
+constexpr size_t max_element(const T* p, size_t n) {
+  if (n == 0) return 0;
+  if constexpr (is_integral_v<T>) {
+    T m = p[0];
+    for (size_t i = 1; i != n; ++i) {
+      m = m < p[i] ? p[i] : m;
+    }
+    return detail::find(p, n, m);
+  } else {
+    size_t best = 0;
+    for (size_t i = 1; i != n; ++i) {
+      if (p[best] < p[i]) best = i;
+    }
+    return best;
+  }
+}
+
+}  // namespace std::ranges::detail
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef LIBCPP__RANGE_INSTRUMENTATION_HPP
+#define LIBCPP__RANGE_INSTRUMENTATION_HPP
+
+#include <cstddef>
+
+namespace std::ranges {
+
+// The erased operations that an instrumentation policy is told about
+enum class any_view_event : unsigned char {
+  deref,
+  iter_move,
+  increment,
+  decrement,
+  equal,
+  advance,
+  distance_to,
+  begin,
+  end,
+  heap_allocation,
+  copy,
+};
+
+inline constexpr size_t __any_view_event_count = 11;
+
+namespace detail {
+
+// The default: nothing is recorded, and the hooks compile to nothing. The
+// counting policy is any_view_instrumentation, in
+// any_view_instrumentation.hpp
+struct no_instrumentation {
+  static constexpr bool enabled = false;
+};
+
+// T is the erased type the event is about. Constant evaluation is never
+// instrumented
+template <class Instrumentation, class T>
+constexpr void instrument([[maybe_unused]] any_view_event e) noexcept {
+  if constexpr (Instrumentation::enabled) {
+    if !consteval {
+      Instrumentation::template record<T>(e);
+    }
+  }
+}
+
+}  // namespace detail
+
+}  // namespace std::ranges
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef LIBCPP__RANGE_ANY_VIEW_PARALLEL_HPP
+#define LIBCPP__RANGE_ANY_VIEW_PARALLEL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "any_view.hpp"
+
+namespace std::ranges {
+
+namespace __any_view_parallel {
+
+// The view is split into more parts than threads. Each thread takes the
+// next part when it is done with the previous one, so that a slow part does
+// not hold back the others
+inline constexpr size_t parts_per_thread = 4;
+
+inline size_t default_threads() {
+  size_t n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+template <class AnyView>
+concept splittable = requires(AnyView& v, size_t n) {
+  { v.split(n) } -> same_as<std::vector<AnyView>>;
+};
+
+// Calls work(part) for every part, on `threads` threads, the calling thread
+// being one of them. If work throws, no other part is started, and the first
+// exception is rethrown on the calling thread once all the threads are done
+template <class AnyView, class Work>
+void run(std::vector<AnyView>& parts, size_t threads, Work& work) {
+  std::atomic<size_t> next = 0;
+  std::atomic<bool> failed = false;
+  std::exception_ptr error;
+  auto worker = [&] {
+    try {
+      for (size_t i = next.fetch_add(1, memory_order_relaxed);
+           i < parts.size(); i = next.fetch_add(1, memory_order_relaxed)) {
+        work(i, parts[i]);
+      }
+    } catch (...) {
+      next.store(parts.size(), memory_order_relaxed);
+      if (!failed.exchange(true, memory_order_relaxed)) {
+        error = std::current_exception();
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace __any_view_parallel
+
+// Calls fn on every element of a random_access and sized any_view, from
+// several threads at once: fn must be safe to call concurrently. The
+// elements of a sub-view are visited in order by the erased for_each, so
+// that there is one indirect call per element. An exception thrown by fn is
+// rethrown on the calling thread
+template <class AnyView, class Fn>
+  requires __any_view_parallel::splittable<AnyView> &&
+           std::invocable<Fn&, range_reference_t<AnyView>>
+void parallel_for_each(
+    AnyView& v, Fn fn,
+    size_t threads = __any_view_parallel::default_threads()) {
+  threads = threads == 0 ? 1 : threads;
+  auto parts = v.split(threads * __any_view_parallel::parts_per_thread);
+  auto work = [&](size_t, AnyView& part) { part.for_each(std::ref(fn)); };
+  __any_view_parallel::run(parts, threads, work);
+}
+
+// op(op(...op(init, x0)...), xn), where op is associative: each sub-view is
+// reduced on one thread, and the results are combined in order
+template <class AnyView, class T, class BinaryOp>
+  requires __any_view_parallel::splittable<AnyView> &&
+           std::constructible_from<T, range_reference_t<AnyView>> &&
+           std::invocable<BinaryOp&, T, range_reference_t<AnyView>> &&
+           std::invocable<BinaryOp&, T, T>
+T parallel_reduce(AnyView& v, T init, BinaryOp op,
+                  size_t threads = __any_view_parallel::default_threads()) {
+  threads = threads == 0 ? 1 : threads;
+  auto parts = v.split(threads * __any_view_parallel::parts_per_thread);
+  std::vector<std::optional<T>> results(parts.size());
+  auto work = [&](size_t i, AnyView& part) {
+    std::optional<T>& acc = results[i];
+    part.for_each([&](range_reference_t<AnyView> elem) {
+      if (acc) {
+        *acc = std::invoke(op, std::move(*acc),
+                           std::forward<range_reference_t<AnyView>>(elem));
+      } else {
+        acc.emplace(std::forward<range_reference_t<AnyView>>(elem));
+      }
+    });
+  };
+  __any_view_parallel::run(parts, threads, work);
+
+  for (auto& r : results) {
+    if (r) {
+      init = std::invoke(op, std::move(init), std::move(*r));
+    }
+  }
+  return init;
+}
+
+}  // namespace std::ranges
+
+#endif
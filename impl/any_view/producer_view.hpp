@@ -0,0 +1,172 @@
+#ifndef LIBCPP__RANGE_PRODUCER_VIEW_HPP
+#define LIBCPP__RANGE_PRODUCER_VIEW_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std::ranges {
+
+namespace __producer_view {
+
+template <class T>
+inline constexpr bool is_optional = false;
+
+template <class T>
+inline constexpr bool is_optional<std::optional<T>> = true;
+
+// a lambda with captures is not assignable, but a view has to be
+template <class F>
+struct movable_box {
+  std::optional<F> f_;
+
+  constexpr explicit movable_box(F f) : f_(std::move(f)) {}
+  constexpr movable_box(movable_box&&) = default;
+  constexpr movable_box& operator=(movable_box&& other) noexcept(
+      is_nothrow_move_constructible_v<F>) {
+    if (this != &other) {
+      f_.reset();
+      if (other.f_) f_.emplace(std::move(*other.f_));
+    }
+    return *this;
+  }
+
+  constexpr F& operator*() { return *f_; }
+};
+
+template <class F>
+concept producer = std::invocable<F&> &&
+                   is_optional<remove_cvref_t<std::invoke_result_t<F&>>>;
+
+}  // namespace __producer_view
+
+// An input view of the values returned by a callable, until it returns
+// nullopt. The callable is called up to N times in a row to fill a buffer,
+// and the iterator walks the buffer, so a streaming source such as a parser
+// or a coroutine is resumed in batches instead of once per element:
+//   any_view<Token> tokens(producer_view([&] { return lexer.next(); }));
+// Like istream_view, the iterators refer to the view
+template <class F, size_t N = 64>
+  requires __producer_view::producer<F> && std::is_object_v<F> &&
+           std::move_constructible<F> && (N > 0)
+class producer_view : public view_interface<producer_view<F, N>> {
+  using T = typename remove_cvref_t<std::invoke_result_t<F&>>::value_type;
+
+ public:
+  struct iterator {
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+
+    constexpr iterator() = default;
+    constexpr iterator(iterator&&) = default;
+    constexpr iterator& operator=(iterator&&) = default;
+
+    constexpr T& operator*() const { return parent_->buf_[parent_->pos_]; }
+
+    constexpr iterator& operator++() {
+      parent_->next();
+      return *this;
+    }
+
+    constexpr void operator++(int) { ++*this; }
+
+    friend constexpr bool operator==(const iterator& it, default_sentinel_t) {
+      return it.at_end();
+    }
+
+    // private:
+    producer_view* parent_ = nullptr;
+
+    constexpr explicit iterator(producer_view* parent) : parent_(parent) {}
+
+    constexpr bool at_end() const {
+      return parent_->pos_ == parent_->buf_.size();
+    }
+  };
+
+  constexpr explicit producer_view(F f) : f_(std::move(f)) {}
+
+  constexpr iterator begin() {
+    if (!started_) {
+      started_ = true;
+      refill();
+    }
+    return iterator(this);
+  }
+
+  constexpr default_sentinel_t end() const noexcept { return default_sentinel; }
+
+ private:
+  constexpr void next() {
+    ++pos_;
+    if (pos_ == buf_.size() && !done_) {
+      refill();
+    }
+  }
+
+  constexpr void refill() {
+    buf_.clear();
+    pos_ = 0;
+    while (buf_.size() != N) {
+      auto v = std::invoke(*f_);
+      if (!v) {
+        done_ = true;
+        return;
+      }
+      buf_.push_back(std::move(*v));
+    }
+  }
+
+  __producer_view::movable_box<F> f_;
+  std::vector<T> buf_ = [] {
+    std::vector<T> v;
+    v.reserve(N);
+    return v;
+  }();
+  size_t pos_ = 0;
+  bool started_ = false;
+  bool done_ = false;
+};
+
+namespace __producer_view {
+
+// the elements of an input view, one per call
+template <class V>
+struct next_of {
+  V base_;
+  std::optional<iterator_t<V>> it_ = std::nullopt;
+
+  constexpr std::optional<range_value_t<V>> operator()() {
+    if (!it_) {
+      it_.emplace(std::ranges::begin(base_));
+    } else {
+      ++*it_;
+    }
+    if (*it_ == std::ranges::end(base_)) {
+      return std::nullopt;
+    }
+    return std::optional<range_value_t<V>>(std::in_place, **it_);
+  }
+};
+
+}  // namespace __producer_view
+
+// Reads an input range, such as a std::generator, ahead in batches of N
+template <size_t N = 64, std::ranges::viewable_range R>
+  requires std::ranges::input_range<R> &&
+           std::constructible_from<range_value_t<R>, range_reference_t<R>>
+constexpr auto read_ahead(R&& r) {
+  using V = views::all_t<R>;
+  return producer_view<__producer_view::next_of<V>, N>(
+      __producer_view::next_of<V>{views::all(std::forward<R>(r))});
+}
+
+}  // namespace std::ranges
+
+#endif
@@ -2,9 +2,13 @@
 #define LIBCPP__RANGE_STORAGE_HPP
 
 #include <concepts>
+#include <cstddef>
+#include <cstring>
 #include <memory>
 #include <type_traits>
 
+#include "instrumentation.hpp"
+
 namespace std::ranges::detail {
 
 template <class T>
@@ -12,39 +16,90 @@ struct type {
   using t = T;
 };
 
-template <size_t Size, size_t Align, bool Copyable>
+// Extension allows the owner of the storage to store its own operations
+// in the same vtable as the lifecycle operations of the storage, so that
+// the erased object is one vtable pointer plus the buffer
+struct no_extension {
+  struct vtable {};
+
+  template <class T>
+  static constexpr vtable generate() {
+    return {};
+  }
+};
+
+// A Copyable storage can also hold move-only objects, for owners that know
+// from the extension which objects are copied. Copying a move-only object is
+// undefined behaviour.
+//
+// The allocator is only used for objects that do not fit the buffer. It
+// travels with the object: it is propagated on copy, move and swap, so that
+// a heap object is always deallocated by the allocator that allocated it.
+//
+// Instrumentation is told about the heap allocations and the copies of each
+// stored type
+template <size_t Size, size_t Align, bool Copyable,
+          class Extension = no_extension,
+          class Alloc = std::allocator<std::byte>,
+          class Instrumentation = no_instrumentation>
 struct storage {
+  using extension_vtable = typename Extension::vtable;
+  using allocator_type = Alloc;
+
+  static_assert(is_nothrow_swappable_v<Alloc>);
+
   constexpr storage() = default;
 
   template <class T, class... Args>
     requires constructible_from<T, Args &&...>
-  constexpr storage(type<T>, Args &&...args) {
+  constexpr storage(type<T> t, Args &&...args)
+      : storage(allocator_arg, Alloc(), t, std::forward<Args>(args)...) {}
+
+  template <class T, class... Args>
+    requires constructible_from<T, Args &&...>
+  constexpr storage(allocator_arg_t, const Alloc &alloc, type<T>,
+                    Args &&...args)
+      : alloc_(alloc) {
     if consteval {
+      heap_ptr_ = allocate<T>(std::forward<Args>(args)...);
       vtable_ = &heap_vtable<T>;
-      heap_ptr_ = new T(std::forward<Args>(args)...);
     } else {
       if constexpr (use_small_buffer<T>) {
         vtable_ = &small_buffer_vtable<T>;
         std::construct_at(get_ptr<T>(), std::forward<Args>(args)...);
       } else {
+        heap_ptr_ = allocate<T>(std::forward<Args>(args)...);
         vtable_ = &heap_vtable<T>;
-        heap_ptr_ = new T(std::forward<Args>(args)...);
       }
     }
   }
 
   constexpr storage(const storage &other)
     requires Copyable
-  {
-    if (!other.is_singular()) {
-      (*(other.vtable_->copy_))(other, *this);
+      : alloc_(allocator_traits<Alloc>::select_on_container_copy_construction(
+            other.alloc_)) {
+    if (other.is_singular()) return;
+    other.record(any_view_event::copy);
+    if !consteval {
+      if (other.vtable_->trivially_copyable_) {
+        copy_bytes(other, *this);
+        return;
+      }
     }
+    (*(other.vtable_->copy_))(other, *this);
   }
 
-  constexpr storage(storage &&other) noexcept {
-    if (!other.is_singular()) {
-      (*(other.vtable_->move_))(std::move(other), *this);
+  constexpr storage(storage &&other) noexcept : alloc_(other.alloc_) {
+    if (other.is_singular()) return;
+    if !consteval {
+      if (other.vtable_->trivially_relocatable_) {
+        copy_bytes(other, *this);
+        // a trivially copyable object is left in place, like move_ does
+        if (!other.vtable_->trivially_copyable_) other.vtable_ = nullptr;
+        return;
+      }
     }
+    (*(other.vtable_->move_))(std::move(other), *this);
   }
 
   constexpr storage &operator=(const storage &other)
@@ -60,9 +115,11 @@ struct storage {
   }
 
   constexpr ~storage() {
-    if (!is_singular()) {
-      (*(vtable_->destroy_))(*this);
+    if (is_singular()) return;
+    if !consteval {
+      if (vtable_->trivially_copyable_) return;
     }
+    (*(vtable_->destroy_))(*this);
   }
 
   template <class T, class Self>
@@ -84,8 +141,21 @@ struct storage {
   constexpr void swap(storage &other) noexcept {
     if (this == &other) return;
 
+    if !consteval {
+      if (is_trivially_relocatable() && other.is_trivially_relocatable()) {
+        storage tmp(singular_tag{}, alloc_);
+        copy_bytes(*this, tmp);
+        copy_bytes(other, *this);
+        copy_bytes(tmp, other);
+        tmp.vtable_ = nullptr;
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        return;
+      }
+    }
+
     if (!is_singular() && !other.is_singular()) {
-      storage tmp(singular_tag{});
+      storage tmp(singular_tag{}, alloc_);
       (*other.vtable_->destructive_move_)(std::move(other), tmp);
       (*vtable_->destructive_move_)(std::move(*this), other);
       (*tmp.vtable_->destructive_move_)(std::move(tmp), *this);
@@ -97,10 +167,31 @@ struct storage {
       (*other.vtable_->destructive_move_)(std::move(other), *this);
       other.vtable_ = nullptr;
     }
+    using std::swap;
+    swap(alloc_, other.alloc_);
   }
 
+  constexpr allocator_type get_allocator() const noexcept { return alloc_; }
+
   constexpr bool is_singular() const { return !vtable_; }
 
+  // whether the stored object is a T
+  template <class T>
+  constexpr bool holds() const noexcept {
+    if consteval {
+      return vtable_ == &heap_vtable<T>;
+    } else {
+      if constexpr (use_small_buffer<T>) {
+        return vtable_ == &small_buffer_vtable<T>;
+      } else {
+        return vtable_ == &heap_vtable<T>;
+      }
+    }
+  }
+
+  // nullptr if singular
+  constexpr const extension_vtable *get_vtable() const { return vtable_; }
+
   template <class T>
   static constexpr bool unittest_is_small() {
     return use_small_buffer<T>;
@@ -113,7 +204,7 @@ struct storage {
 
  private:
   struct singular_tag {};
-  explicit constexpr storage(singular_tag) {};
+  constexpr storage(singular_tag, const Alloc &alloc) : alloc_(alloc) {}
 
   struct Buffer {
     static constexpr size_t size = Size;
@@ -130,23 +221,91 @@ struct storage {
     Buffer buf_;
   };
 
+  static constexpr size_t union_size =
+      sizeof(Buffer) > sizeof(void *) ? sizeof(Buffer) : sizeof(void *);
+
   struct empty {};
   struct copyable_vtable {
     void (*copy_)(const storage &, storage &);
   };
-  struct vtable : conditional_t<Copyable, copyable_vtable, empty> {
+  struct instrumented_vtable {
+    void (*record_)(any_view_event) noexcept;
+  };
+  struct not_instrumented {};
+  // the extension entries come first, they are the hot ones
+  struct vtable : extension_vtable,
+                  conditional_t<Copyable, copyable_vtable, empty>,
+                  conditional_t<Instrumentation::enabled, instrumented_vtable,
+                                not_instrumented> {
     void (*destroy_)(storage &);
     void (*move_)(storage &&, storage &);
     void (*destructive_move_)(storage &&, storage &);
+    // copy, move and destroy are memcpy and no-op, without indirect calls
+    bool trivially_copyable_;
+    // move and swap are memcpy: trivially copyable objects in the small
+    // buffer, and all objects on the heap as only the pointer is moved
+    bool trivially_relocatable_;
   };
 
   static_assert(alignof(vtable) % 2 == 0);
 
+  // the copies in the memcpy path do not know the type, so the type is
+  // recorded through the vtable
+  constexpr void record([[maybe_unused]] any_view_event e) const noexcept {
+    if constexpr (Instrumentation::enabled) {
+      if !consteval {
+        (*vtable_->record_)(e);
+      }
+    }
+  }
+
   vtable const *vtable_ = nullptr;
 
+  constexpr bool is_trivially_relocatable() const {
+    return is_singular() || vtable_->trivially_relocatable_;
+  }
+
+  // runtime only: the whole buffer is copied, whatever the size of the
+  // object, so that the copy is a few word moves
+  static void copy_bytes(const storage &from, storage &to) noexcept {
+    std::memcpy(static_cast<void *>(&to.buf_),
+                static_cast<const void *>(&from.buf_), union_size);
+    to.vtable_ = from.vtable_;
+  }
+  [[no_unique_address]] Alloc alloc_ = Alloc();
+
+  template <class Tp>
+  using alloc_traits =
+      typename allocator_traits<Alloc>::template rebind_traits<Tp>;
+
+  template <class Tp, class... Args>
+  constexpr Tp *allocate(Args &&...args) {
+    instrument<Instrumentation, Tp>(any_view_event::heap_allocation);
+    typename alloc_traits<Tp>::allocator_type alloc(alloc_);
+    Tp *ptr = alloc_traits<Tp>::allocate(alloc, 1);
+    try {
+      alloc_traits<Tp>::construct(alloc, ptr, std::forward<Args>(args)...);
+    } catch (...) {
+      alloc_traits<Tp>::deallocate(alloc, ptr, 1);
+      throw;
+    }
+    return ptr;
+  }
+
+  template <class Tp>
+  constexpr void deallocate(Tp *ptr) noexcept {
+    typename alloc_traits<Tp>::allocator_type alloc(alloc_);
+    alloc_traits<Tp>::destroy(alloc, ptr);
+    alloc_traits<Tp>::deallocate(alloc, ptr, 1);
+  }
+
   template <class Tp>
   consteval static vtable gen_vtable_small_buffer() {
     vtable vt{};
+    static_cast<extension_vtable &>(vt) = Extension::template generate<Tp>();
+    if constexpr (Instrumentation::enabled) {
+      vt.record_ = &Instrumentation::template record<Tp>;
+    }
     vt.destroy_ = [](storage &self) noexcept {
       std::destroy_at(self.get_ptr<Tp>());
     };
@@ -159,21 +318,27 @@ struct storage {
       dest.vtable_ = self.vtable_;
       std::destroy_at(self.get_ptr<Tp>());
     };
-    if constexpr (Copyable) {
+    if constexpr (Copyable && is_copy_constructible_v<Tp>) {
       // may throw, but self is unchanged after throw
       vt.copy_ = [](storage const &self, storage &dest) {
         std::construct_at(dest.get_ptr<Tp>(), *self.get_ptr<Tp>());
         dest.vtable_ = self.vtable_;
       };
     }
+    vt.trivially_copyable_ = is_trivially_copyable_v<Tp>;
+    vt.trivially_relocatable_ = is_trivially_copyable_v<Tp>;
     return vt;
   }
 
   template <class Tp>
   consteval static vtable gen_vtable_allocation() {
     vtable vt{};
+    static_cast<extension_vtable &>(vt) = Extension::template generate<Tp>();
+    if constexpr (Instrumentation::enabled) {
+      vt.record_ = &Instrumentation::template record<Tp>;
+    }
     vt.destroy_ = [](storage &self) noexcept {
-      delete static_cast<Tp *>(self.heap_ptr_);
+      self.deallocate(static_cast<Tp *>(self.heap_ptr_));
     };
     vt.move_ = [](storage &&self, storage &dest) noexcept {
       dest.heap_ptr_ = self.heap_ptr_;
@@ -182,13 +347,16 @@ struct storage {
       self.vtable_ = nullptr;
     };
     vt.destructive_move_ = vt.move_;
-    if constexpr (Copyable) {
+    if constexpr (Copyable && is_copy_constructible_v<Tp>) {
       vt.copy_ = [](storage const &self, storage &dest) {
         // may throw, but self is unchanged after throw
-        dest.heap_ptr_ = new Tp(*static_cast<const Tp *>(self.heap_ptr_));
+        dest.heap_ptr_ = dest.template allocate<Tp>(
+            *static_cast<const Tp *>(self.heap_ptr_));
         dest.vtable_ = self.vtable_;
       };
     }
+    vt.trivially_copyable_ = false;
+    vt.trivially_relocatable_ = true;
     return vt;
   }
 
@@ -0,0 +1,102 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[next_batch]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+using Iter = std::ranges::iterator_t<AnyView>;
+
+template <class T>
+concept has_next_batch = requires(T& t, std::ranges::sentinel_t<T> s) {
+  t.begin().next_batch({}, s);
+};
+
+static_assert(has_next_batch<AnyView>);
+static_assert(has_next_batch<std::ranges::any_view<
+                  int, std::ranges::any_view_options::input, int>>);
+static_assert(!has_next_batch<std::ranges::any_view<int>>,
+              "references of input iterators are invalidated by increment");
+
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  Iter iter = v.begin();
+  auto last = v.end();
+  std::array<int*, 2> buf{};
+
+  {
+    std::same_as<size_t> decltype(auto) n = iter.next_batch(buf, last);
+    assert(n == 2);
+    assert(buf[0] == &a[0]);
+    assert(buf[1] == &a[1]);
+    assert(*iter == 3);
+  }
+
+  {
+    auto n = iter.next_batch(buf, last);
+    assert(n == 2);
+    assert(buf[0] == &a[2]);
+    assert(buf[1] == &a[3]);
+  }
+
+  {
+    auto n = iter.next_batch(buf, last);
+    assert(n == 1);
+    assert(buf[0] == &a[4]);
+    assert(iter == last);
+  }
+
+  {
+    auto n = iter.next_batch(buf, last);
+    assert(n == 0);
+  }
+}
+
+constexpr void prvalue() {
+  int a[] = {1, 2, 3, 4, 5};
+  std::ranges::any_view<int, std::ranges::any_view_options::input, int> v(
+      InputView{a} | std::views::transform([](int i) { return i * 10; }));
+
+  auto iter = v.begin();
+  auto last = v.end();
+  std::array<int, 4> buf{};
+  int sum = 0;
+  size_t calls = 0;
+  while (auto n = iter.next_batch(buf, last)) {
+    ++calls;
+    for (size_t i = 0; i != n; ++i) {
+      sum += buf[i];
+    }
+  }
+  assert(sum == 150);
+  assert(calls == 2);
+}
+
+constexpr void empty() {
+  AnyView v;
+  auto iter = v.begin();
+  std::array<int*, 2> buf{};
+  assert(iter.next_batch(buf, v.end()) == 0);
+}
+
+constexpr bool test() {
+  basic();
+  prvalue();
+  empty();
+  return true;
+}
+
+TEST_POINT("next_batch") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
@@ -28,6 +28,8 @@ static_assert(
 static_assert(std::same_as<typename std::iterator_traits<Iter>::difference_type,
                            ptrdiff_t>);
 
+static_assert(std::same_as<Iter, int*>);
+
 static_assert(std::is_nothrow_move_constructible_v<Iter>);
 static_assert(std::is_nothrow_move_assignable_v<Iter>);
 
@@ -204,8 +206,9 @@ constexpr void contiguous() {
 
   Iter iter = v.begin();
 
-  auto* p = iter.operator->();
+  std::same_as<int*> decltype(auto) p = std::to_address(iter);
   assert(*p == 1);
+  assert(p == a.data());
 }
 
 constexpr void compare() {
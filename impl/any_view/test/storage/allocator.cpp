@@ -0,0 +1,146 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+
+#include "storage.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[storage]")
+
+namespace {
+
+struct Counts {
+  int allocate = 0;
+  int deallocate = 0;
+};
+
+template <class T>
+struct CountingAllocator {
+  using value_type = T;
+
+  Counts* counts_;
+
+  constexpr CountingAllocator(Counts& c) : counts_(&c) {}
+  template <class U>
+  constexpr CountingAllocator(const CountingAllocator<U>& other)
+      : counts_(other.counts_) {}
+
+  constexpr T* allocate(size_t n) {
+    ++counts_->allocate;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  constexpr void deallocate(T* p, size_t n) {
+    ++counts_->deallocate;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <class U>
+  constexpr bool operator==(const CountingAllocator<U>& other) const {
+    return counts_ == other.counts_;
+  }
+};
+
+using Alloc = CountingAllocator<std::byte>;
+using Storage =
+    std::ranges::detail::storage<3 * sizeof(void*), sizeof(void*), true,
+                                 std::ranges::detail::no_extension, Alloc>;
+
+using std::ranges::detail::type;
+
+struct Big {
+  constexpr Big(int ii) : i(ii) {}
+  int i;
+  char c[100] = {};
+};
+
+static_assert(sizeof(std::ranges::detail::storage<
+                  3 * sizeof(void*), sizeof(void*), true>) ==
+                  4 * sizeof(void*),
+              "the default allocator takes no space");
+
+constexpr void small() {
+  Counts counts;
+  {
+    Storage s(std::allocator_arg, Alloc(counts), type<int>{}, 5);
+    Storage copy(s);
+    Storage moved(std::move(s));
+    assert(*copy.get_ptr<int>() == 5);
+    assert(*moved.get_ptr<int>() == 5);
+  }
+  if (!std::is_constant_evaluated()) {
+    assert(counts.allocate == 0);
+  }
+  assert(counts.allocate == counts.deallocate);
+}
+
+constexpr void big() {
+  Counts counts;
+  {
+    Storage s(std::allocator_arg, Alloc(counts), type<Big>{}, 5);
+    assert(counts.allocate == 1);
+
+    Storage copy(s);
+    assert(counts.allocate == 2);
+    assert(copy.get_allocator() == Alloc(counts));
+    assert(copy.get_ptr<Big>()->i == 5);
+
+    Storage moved(std::move(s));
+    assert(counts.allocate == 2);
+    assert(moved.get_ptr<Big>()->i == 5);
+    assert(counts.deallocate == 0);
+  }
+  assert(counts.allocate == 2);
+  assert(counts.deallocate == 2);
+}
+
+constexpr void swap() {
+  Counts counts1;
+  Counts counts2;
+  {
+    Storage s1(std::allocator_arg, Alloc(counts1), type<Big>{}, 1);
+    Storage s2(std::allocator_arg, Alloc(counts2), type<int>{}, 2);
+    s1.swap(s2);
+    assert(*s1.get_ptr<int>() == 2);
+    assert(s2.get_ptr<Big>()->i == 1);
+    assert(s1.get_allocator() == Alloc(counts2));
+    assert(s2.get_allocator() == Alloc(counts1));
+
+    // the heap object is released by the allocator that allocated it
+    s2 = std::move(s1);
+    assert(counts1.deallocate == 1);
+    assert(s2.get_allocator() == Alloc(counts2));
+  }
+  assert(counts1.allocate == counts1.deallocate);
+  assert(counts2.allocate == counts2.deallocate);
+}
+
+constexpr bool test() {
+  small();
+  big();
+  swap();
+  return true;
+}
+
+TEST_POINT("allocator") {
+  test();
+  static_assert(test());
+}
+
+struct ThrowingBig {
+  ThrowingBig(int) { throw std::runtime_error("ctor"); }
+  char c[100] = {};
+};
+
+TEST_POINT("allocator_construct_throws") {
+  Counts counts;
+  try {
+    Storage s(std::allocator_arg, Alloc(counts), type<ThrowingBig>{}, 1);
+    assert(false);
+  } catch (const std::runtime_error&) {
+  }
+  assert(counts.allocate == 1);
+  assert(counts.deallocate == 1);
+}
+
+}  // namespace
@@ -88,6 +88,16 @@ constexpr void basic() {
   assert(*s.get_ptr<T>() == 5);
 }
 
+template <class T>
+constexpr void holds() {
+  Storage s;
+  assert(!s.holds<T>());
+  s = Storage{type<T>{}, 5};
+  assert(s.holds<T>());
+  assert(!s.holds<long>());
+  assert(!s.holds<Track<T>>());
+}
+
 template <class T>
 constexpr void copy() {
   // non singular
@@ -434,17 +444,104 @@ constexpr void copy_assignment() {
   }
 }
 
+struct Extension {
+  struct vtable {
+    int (*get_)(const std::ranges::detail::storage<
+                3 * sizeof(void*), sizeof(void*), true, Extension>&);
+  };
+
+  template <class T>
+  static constexpr vtable generate() {
+    vtable t;
+    t.get_ = [](const auto& self) -> int {
+      return *self.template get_ptr<T>();
+    };
+    return t;
+  }
+};
+
+using ExtStorage =
+    std::ranges::detail::storage<3 * sizeof(void*), sizeof(void*), true,
+                                 Extension>;
+
+// the extension entries share the vtable of the copy, move and destroy
+// operations, so the erased iterators hold a single vtable pointer
+static_assert(sizeof(ExtStorage) == sizeof(Storage));
+
+template <class T>
+constexpr void extension() {
+  ExtStorage s0;
+  assert(s0.get_vtable() == nullptr);
+
+  ExtStorage s1{type<T>{}, 5};
+  assert((*s1.get_vtable()->get_)(s1) == 5);
+
+  ExtStorage s2{s1};
+  assert(s2.get_vtable() == s1.get_vtable());
+  assert((*s2.get_vtable()->get_)(s2) == 5);
+
+  ExtStorage s3{std::move(s2)};
+  assert((*s3.get_vtable()->get_)(s3) == 5);
+
+  s3 = ExtStorage{type<T>{}, 6};
+  assert((*s3.get_vtable()->get_)(s3) == 6);
+}
+
+// swap takes the memcpy path when both sides are trivially relocatable
+// (trivially copyable objects in the small buffer, objects on the heap) and
+// the vtable path otherwise
+template <class T, class U>
+constexpr void swap() {
+  {
+    Storage s1{type<T>{}, 1};
+    Storage s2{type<U>{}, 2};
+    s1.swap(s2);
+    assert(*s1.get_ptr<U>() == 2);
+    assert(*s2.get_ptr<T>() == 1);
+    s1.swap(s1);
+    assert(*s1.get_ptr<U>() == 2);
+  }
+
+  {
+    Storage s1{type<T>{}, 1};
+    Storage s2{};
+    s1.swap(s2);
+    assert(s1.is_singular());
+    assert(*s2.get_ptr<T>() == 1);
+    s1.swap(s2);
+    assert(s2.is_singular());
+    assert(*s1.get_ptr<T>() == 1);
+  }
+
+  {
+    Stats stats{};
+    {
+      Storage s1{type<Track<T>>{}, stats, 1};
+      Storage s2{type<U>{}, 2};
+      s1.swap(s2);
+      assert(*s1.get_ptr<U>() == 2);
+      assert(s2.get_ptr<Track<T>>()->t_ == 1);
+    }
+    assert(stats.construct + stats.copy_construct + stats.move_construct ==
+           stats.destroy);
+  }
+}
+
 constexpr void on_heap() {
   singular();
   basic<Big>();
+  holds<Big>();
   copy<Big>();
   move<Big>();
   copy_assignment<Big, Big>();
   move_assignment<Big, Big>();
+  extension<Big>();
+  swap<Big, Big>();
 }
 
 constexpr void on_small_buffer() {
   basic<Small>();
+  holds<Small>();
   copy<Small>();
   move<Small>();
   copy_assignment<Small, Small>();
@@ -453,6 +550,10 @@ constexpr void on_small_buffer() {
   move_assignment<Small, Small>();
   move_assignment<Big, Small>();
   move_assignment<Small, Big>();
+  extension<Small>();
+  swap<Small, Small>();
+  swap<Small, Big>();
+  swap<Big, Small>();
 }
 
 constexpr bool test() {
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[algorithms]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+
+template <class V>
+concept has_algorithms = requires(V& v) {
+  v.find(0);
+  v.count(0);
+  v.accumulate();
+  v.min_element();
+  v.max_element();
+};
+
+static_assert(has_algorithms<AnyView>);
+static_assert(has_algorithms<std::ranges::any_view<
+                  double, std::ranges::any_view_options::random_access>>);
+static_assert(!has_algorithms<std::ranges::any_view<int>>);
+static_assert(!has_algorithms<std::ranges::any_view<
+                  std::string, std::ranges::any_view_options::forward>>);
+
+// the results are those of the std algorithms through the iterators
+template <class V, class R>
+constexpr void check(V& v, R& r) {
+  for (int x : {0, 3, 7, 40, 41, 100}) {
+    assert(v.find(x) == std::ranges::find(v, x));
+    assert(v.count(x) == std::ranges::count(v, x));
+  }
+  assert(v.accumulate() == std::accumulate(r.begin(), r.end(), 0));
+  assert(v.accumulate(5) == std::accumulate(r.begin(), r.end(), 5));
+  assert(v.min_element() == std::ranges::min_element(v));
+  assert(v.max_element() == std::ranges::max_element(v));
+}
+
+std::vector<int> values() {
+  std::vector<int> v;
+  for (int i = 0; i != 50; ++i) {
+    v.push_back((i * 7) % 41);
+  }
+  return v;
+}
+
+// a vector<int> is walked with the vectorized loops
+void array() {
+  std::vector<int> vec = values();
+  AnyView v(std::views::all(vec));
+  check(v, vec);
+
+  // the first of the equal elements
+  assert(*v.min_element() == 0);
+  assert(std::ranges::distance(v.begin(), v.min_element()) == 0);
+  assert(*v.max_element() == 40);
+  assert(std::ranges::distance(v.begin(), v.max_element()) == 35);
+  assert(std::ranges::distance(v.begin(), v.find(3)) == 18);
+  assert(v.find(100) == v.end());
+}
+
+void list() {
+  std::vector<int> vec = values();
+  std::list<int> l(vec.begin(), vec.end());
+  AnyView v(std::views::all(l));
+  check(v, l);
+}
+
+// the elements are converted to Ref
+void conversion() {
+  std::vector<int> vec = values();
+  std::ranges::any_view<long, std::ranges::any_view_options::forward, long> v(
+      std::views::all(vec));
+  assert(v.count(3) == 1);
+  assert(v.accumulate() == std::accumulate(vec.begin(), vec.end(), 0L));
+  assert(*v.max_element() == 40);
+}
+
+// NaN is compared like std::min_element does
+void floating_point() {
+  std::vector<double> vec{std::numeric_limits<double>::quiet_NaN(), 1.0, 0.5,
+                          0.5, 2.0};
+  std::ranges::any_view<double, std::ranges::any_view_options::forward> v(
+      std::views::all(vec));
+  assert(v.min_element() == v.begin());
+  assert(v.max_element() == v.begin());
+  assert(v.find(0.5) == std::ranges::next(v.begin(), 2));
+  assert(v.count(0.5) == 2);
+  assert(std::isnan(v.accumulate()));
+
+  vec[0] = 1.5;
+  assert(*v.min_element() == 0.5);
+  assert(v.min_element() == std::ranges::next(v.begin(), 2));
+  assert(v.accumulate(1.0) == 6.5);
+}
+
+void options() {
+  std::vector<int> vec = values();
+
+  std::ranges::any_view<int, std::ranges::any_view_options::contiguous> c(
+      std::views::all(vec));
+  assert(c.find(40) == vec.data() + 35);
+  assert(c.min_element() == vec.data());
+
+  std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                 std::ranges::any_view_options::sized |
+                                 std::ranges::any_view_options::indexed>
+      i(std::views::all(vec));
+  assert(i.find(40) - i.begin() == 35);
+  assert(i.max_element() == i.begin() + 35);
+
+  std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                 std::ranges::any_view_options::sized |
+                                 std::ranges::any_view_options::counted>
+      n(std::views::all(vec));
+  assert(n.find(40).count() == 15);
+  assert(n.find(100) == n.end());
+}
+
+constexpr bool test() {
+  std::vector<int> vec{3, 1, 4, 1, 5, 9, 2, 6};
+  AnyView v(std::views::all(vec));
+  check(v, vec);
+  assert(v.accumulate() == 31);
+  assert(*v.find(5) == 5);
+
+  AnyView empty;
+  assert(empty.find(1) == empty.end());
+  assert(empty.count(1) == 0);
+  assert(empty.accumulate(7) == 7);
+  assert(empty.min_element() == empty.end());
+  assert(empty.max_element() == empty.end());
+  return true;
+}
+
+TEST_POINT("algorithms") {
+  array();
+  list();
+  conversion();
+  floating_point();
+  options();
+}
+
+TEST_POINT("algorithms constexpr") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
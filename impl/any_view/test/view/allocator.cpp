@@ -0,0 +1,128 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory_resource>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[allocator]")
+
+namespace {
+
+struct CountingResource : std::pmr::memory_resource {
+  int allocations = 0;
+  int deallocations = 0;
+
+  void* do_allocate(size_t bytes, size_t align) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// an iterator that does not fit the small buffer of the iterator
+struct FatIter {
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  int* p = nullptr;
+  std::array<char, 64> state{};
+
+  int& operator*() const { return *p; }
+  FatIter& operator++() {
+    ++p;
+    return *this;
+  }
+  FatIter operator++(int) {
+    auto tmp = *this;
+    ++p;
+    return tmp;
+  }
+  friend bool operator==(const FatIter& x, const FatIter& y) {
+    return x.p == y.p;
+  }
+};
+
+using FatView = std::ranges::subrange<FatIter>;
+
+using AnyView = std::ranges::pmr::any_view<
+    int, std::ranges::any_view_options::forward |
+             std::ranges::any_view_options::copyable>;
+
+static_assert(std::ranges::forward_range<AnyView>);
+static_assert(std::ranges::view<AnyView>);
+static_assert(!AnyView::view_storage::unittest_is_small<FatView>());
+static_assert(!AnyView::iterator_storage::unittest_is_small<FatIter>());
+
+TEST_POINT("pmr") {
+  std::array a{1, 2, 3, 4, 5};
+  CountingResource resource;
+  {
+    AnyView v(std::allocator_arg, &resource,
+              FatView(FatIter{a.data()}, FatIter{a.data() + a.size()}));
+    assert(v.get_allocator().resource() == &resource);
+    assert(resource.allocations == 1);
+
+    int sum = 0;
+    for (int i : v) {
+      sum += i;
+    }
+    assert(sum == 15);
+    assert(resource.allocations == 3);  // begin() and end()
+
+    auto it1 = v.begin();
+    auto it2 = it1;
+    ++it2;
+    assert(*it1 == 1);
+    assert(*it2 == 2);
+    assert(resource.allocations == 5);
+
+    AnyView copy = v;
+    assert(resource.allocations == 6);
+
+    AnyView moved = std::move(v);
+    assert(resource.allocations == 6);
+    assert(moved.get_allocator().resource() == &resource);
+  }
+  assert(resource.allocations == resource.deallocations);
+}
+
+TEST_POINT("pmr_swap") {
+  std::array a{1, 2, 3};
+  CountingResource r1;
+  CountingResource r2;
+  {
+    AnyView v1(std::allocator_arg, &r1,
+               FatView(FatIter{a.data()}, FatIter{a.data() + a.size()}));
+    AnyView v2(std::allocator_arg, &r2, std::views::all(a));
+    v1.swap(v2);
+    assert(v1.get_allocator().resource() == &r2);
+    assert(v2.get_allocator().resource() == &r1);
+
+    // iterators follow the allocator of their view
+    auto it = v2.begin();
+    assert(*it == 1);
+    assert(r1.allocations == 2);
+    assert(r2.allocations == 0);
+  }
+  assert(r1.allocations == r1.deallocations);
+}
+
+TEST_POINT("pmr_default_resource") {
+  std::array a{1, 2, 3};
+  AnyView v(a);
+  assert(v.get_allocator().resource() == std::pmr::get_default_resource());
+  assert(*v.begin() == 1);
+}
+
+}  // namespace
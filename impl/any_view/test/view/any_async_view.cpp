@@ -0,0 +1,202 @@
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_async_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[any_async_view]")
+
+namespace {
+
+// runs a coroutine to completion, wherever it is resumed
+struct task {
+  struct promise_type {
+    std::promise<void> done_;
+
+    task get_return_object() { return task{done_.get_future()}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() { done_.set_value(); }
+    void unhandled_exception() {
+      done_.set_exception(std::current_exception());
+    }
+  };
+
+  std::future<void> done_;
+
+  void wait() { done_.get(); }
+};
+
+template <class T>
+struct ready {
+  T value_;
+
+  bool await_ready() const noexcept { return true; }
+  void await_suspend(std::coroutine_handle<>) const noexcept {}
+  T await_resume() { return std::move(value_); }
+};
+
+// an asynchronous range whose awaitables never suspend
+struct ReadyRange {
+  std::vector<int> v_;
+
+  struct iterator {
+    std::vector<int>::iterator it_;
+
+    int& operator*() const { return *it_; }
+    ready<bool> operator++() {
+      ++it_;
+      return {true};
+    }
+    bool operator==(const std::vector<int>::iterator& last) const {
+      return it_ == last;
+    }
+  };
+
+  ready<iterator> begin() { return {{v_.begin()}}; }
+  std::vector<int>::iterator end() { return v_.end(); }
+};
+
+using AsyncView = std::ranges::any_async_view<int>;
+
+static_assert(std::is_constructible_v<AsyncView, ReadyRange>);
+static_assert(!std::is_constructible_v<AsyncView, std::vector<int>>);
+static_assert(!std::is_copy_constructible_v<AsyncView>);
+static_assert(std::is_copy_constructible_v<std::ranges::any_async_view<
+                  int, std::ranges::any_view_options::input |
+                           std::ranges::any_view_options::copyable>>);
+
+// the allocator-extended constructor has the same constraints
+struct MoveOnlyRange : ReadyRange {
+  std::unique_ptr<int> p_;
+};
+
+using CopyableAsyncView = std::ranges::any_async_view<
+    int, std::ranges::any_view_options::input |
+             std::ranges::any_view_options::copyable>;
+using Alloc = std::ranges::any_view_policy::allocator_type;
+
+static_assert(std::is_constructible_v<AsyncView, std::allocator_arg_t,
+                                      const Alloc&, MoveOnlyRange>);
+static_assert(!std::is_constructible_v<CopyableAsyncView, MoveOnlyRange>);
+static_assert(!std::is_constructible_v<CopyableAsyncView,
+                                       std::allocator_arg_t, const Alloc&,
+                                       MoveOnlyRange>);
+static_assert(!std::is_constructible_v<std::ranges::any_async_view<std::string>,
+                                       std::allocator_arg_t, const Alloc&,
+                                       ReadyRange>);
+
+task sum(AsyncView& v, int& out) {
+  for (auto it = co_await v.begin(); it != v.end(); co_await ++it) {
+    out += *it;
+  }
+}
+
+TEST_POINT("ready") {
+  AsyncView v(ReadyRange{{1, 2, 3, 4}});
+  int out = 0;
+  sum(v, out).wait();
+  assert(out == 10);
+
+  AsyncView empty(ReadyRange{});
+  out = 0;
+  sum(empty, out).wait();
+  assert(out == 0);
+}
+
+using Chunks = std::ranges::any_async_view<
+    std::span<const std::byte>, std::ranges::any_view_options::input,
+    std::span<const std::byte>>;
+
+task total(Chunks& v, size_t& bytes, size_t& chunks) {
+  for (auto it = co_await v.begin(); it != v.end(); co_await ++it) {
+    bytes += (*it).size();
+    ++chunks;
+  }
+}
+
+TEST_POINT("fd_chunks") {
+  int fds[2];
+  [[maybe_unused]] int r = ::pipe(fds);
+  assert(r == 0);
+
+  // the consumer suspends until the writer sends the next chunk
+  std::thread writer([fd = fds[1]] {
+    std::vector<std::byte> data(1000, std::byte{1});
+    for (int i = 0; i != 5; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      [[maybe_unused]] auto n = ::write(fd, data.data(), data.size());
+      assert(n == 1000);
+    }
+    ::close(fd);
+  });
+
+  Chunks v(std::ranges::fd_chunks(fds[0], 256));
+  size_t bytes = 0;
+  size_t chunks = 0;
+  total(v, bytes, chunks).wait();
+  writer.join();
+  ::close(fds[0]);
+
+  assert(bytes == 5000);
+  assert(chunks >= 20);
+}
+
+// a pending read follows a moved fd_chunks, and the moved-from one has
+// nothing to cancel
+TEST_POINT("fd_chunks move") {
+  int fds[2];
+  [[maybe_unused]] int r = ::pipe(fds);
+  assert(r == 0);
+  {
+    std::ranges::fd_chunks chunks(fds[0]);
+    auto read = chunks.begin();
+    assert(!read.await_ready());
+    read.await_suspend(std::noop_coroutine());
+
+    std::ranges::fd_chunks moved(std::move(chunks));
+    char c = 1;
+    [[maybe_unused]] auto n = ::write(fds[1], &c, 1);
+    assert(n == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    auto it = read.await_resume();
+    assert((*it).size() == 1);
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+// destroying the fd_chunks cancels the pending read: the consumer is not
+// resumed and the data stays in the pipe
+TEST_POINT("fd_chunks cancel") {
+  int fds[2];
+  [[maybe_unused]] int r = ::pipe(fds);
+  assert(r == 0);
+  {
+    std::ranges::fd_chunks chunks(fds[0]);
+    auto read = chunks.begin();
+    assert(!read.await_ready());
+    read.await_suspend(std::noop_coroutine());
+  }
+  char c = 1;
+  [[maybe_unused]] auto n = ::write(fds[1], &c, 1);
+  assert(n == 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  n = ::read(fds[0], &c, 1);
+  assert(n == 1);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+}  // namespace
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../helper.hpp"
+#include "any_output_range.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[any_output_range]")
+
+namespace {
+
+using Out = std::ranges::any_output_range<int>;
+
+static_assert(std::ranges::output_range<Out, int>);
+static_assert(std::output_iterator<Out::iterator, const int&>);
+static_assert(std::constructible_from<Out, std::vector<int>&>);
+static_assert(std::constructible_from<Out, std::deque<int>&>);
+static_assert(!std::constructible_from<Out, const std::vector<int>&>);
+static_assert(!std::constructible_from<Out, std::vector<std::string>&>);
+
+// a fixed size ring buffer that keeps the last N values, and counts the
+// calls it gets
+template <size_t N>
+struct ring_buffer {
+  std::array<int, N> buf_{};
+  size_t next_ = 0;
+  int* pushes_;
+  int* batches_;
+
+  constexpr void push(int v) {
+    ++*pushes_;
+    buf_[next_++ % N] = v;
+  }
+
+  constexpr void push_batch(std::span<const int> values) {
+    ++*batches_;
+    for (int v : values) {
+      buf_[next_++ % N] = v;
+    }
+  }
+};
+
+constexpr void vector() {
+  std::vector<int> vec;
+  Out out(vec);
+
+  out.push(1);
+  int two = 2;
+  out.push(two);
+  std::array batch{3, 4, 5};
+  out.push_batch(batch);
+  assert((vec == std::vector{1, 2, 3, 4, 5}));
+
+  out.reserve(100);
+  assert(vec.capacity() >= 105);
+
+  std::ranges::copy(std::views::iota(6, 9), out.begin());
+  assert((vec == std::vector{1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+constexpr void user_sink() {
+  int pushes = 0;
+  int batches = 0;
+  // owned by the any_output_range
+  Out out(ring_buffer<4>{{}, 0, &pushes, &batches});
+  out.push(1);
+  out.push(2);
+  std::array batch{3, 4, 5};
+  out.push_batch(batch);
+  out.reserve(10);
+  assert(pushes == 2);
+  assert(batches == 1);
+
+  ring_buffer<4> ring{{}, 0, &pushes, &batches};
+  Out ref(ring);
+  ref.push_batch(batch);
+  ref.push(6);
+  assert((ring.buf_ == std::array{3, 4, 5, 6}));
+}
+
+constexpr void move_only() {
+  std::vector<std::unique_ptr<int>> vec;
+  std::ranges::any_output_range<std::unique_ptr<int>> out(vec);
+  out.push(std::make_unique<int>(1));
+  *out.begin() = std::make_unique<int>(2);
+  assert(vec.size() == 2);
+  assert(*vec[1] == 2);
+}
+
+constexpr void moved_from() {
+  std::vector<int> vec;
+  Out out(vec);
+  Out other(std::move(out));
+  other.push(1);
+  out = std::move(other);
+  out.push(2);
+  assert((vec == std::vector{1, 2}));
+}
+
+void other_containers() {
+  std::set<int> s;
+  Out out(s);
+  std::array batch{3, 1, 2, 3};
+  out.push_batch(batch);
+  out.push(0);
+  assert((s == std::set{0, 1, 2, 3}));
+
+  std::deque<std::string> d;
+  std::ranges::any_output_range<std::string> strings(d);
+  strings.push("a");
+  std::array<std::string, 2> more{"b", "c"};
+  strings.push_batch(more);
+  assert((d == std::deque<std::string>{"a", "b", "c"}));
+}
+
+void file() {
+  std::FILE* f = std::tmpfile();
+  int fd = ::fileno(f);
+  {
+    Out out(std::ranges::fd_writer<int>(fd, 4 * sizeof(int)));
+    out.push(1);
+    std::array small{2, 3};
+    out.push_batch(small);
+    std::vector<int> large(10, 4);
+    out.push_batch(large);
+    out.push(5);
+  }
+  std::rewind(f);
+  std::array<int, 14> read{};
+  assert(std::fread(read.data(), sizeof(int), read.size(), f) == 14);
+  assert(read[0] == 1);
+  assert(read[2] == 3);
+  assert(read[12] == 4);
+  assert(read[13] == 5);
+  std::fclose(f);
+}
+
+// the values of the assigned to writer are written before it takes over
+void file_move_assignment() {
+  std::FILE* f = std::tmpfile();
+  int fd = ::fileno(f);
+  {
+    std::ranges::fd_writer<int> first(fd);
+    first.push(1);
+    std::ranges::fd_writer<int> second(fd);
+    second.push(2);
+    first = std::move(second);
+    first.push(3);
+  }
+  std::rewind(f);
+  std::array<int, 4> read{};
+  assert(std::fread(read.data(), sizeof(int), read.size(), f) == 3);
+  assert((read == std::array{1, 2, 3, 0}));
+  std::fclose(f);
+}
+
+// only flush() reports a failed write, the destructor ignores it
+void file_error() {
+  std::ranges::fd_writer<int> w(-1);
+  w.push(1);
+  bool caught = false;
+  try {
+    w.flush();
+  } catch (const std::system_error& e) {
+    caught = e.code() == std::errc::bad_file_descriptor;
+  }
+  assert(caught);
+}
+
+// a write that fails after a short write keeps only the bytes that were
+// not written: the pipe takes part of the buffer, then would block
+void file_short_write() {
+  int fds[2];
+  [[maybe_unused]] int r = ::pipe(fds);
+  assert(r == 0);
+  ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  ::fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+  std::vector<int> values(1 << 18);
+  std::iota(values.begin(), values.end(), 0);
+  std::vector<int> read;
+  auto drain = [&] {
+    std::array<int, 1024> chunk;
+    ssize_t n;
+    while ((n = ::read(fds[0], chunk.data(), sizeof(chunk))) > 0) {
+      assert(n % sizeof(int) == 0);
+      read.insert(read.end(), chunk.begin(), chunk.begin() + n / sizeof(int));
+    }
+  };
+
+  std::ranges::fd_writer<int> w(fds[1], values.size() * sizeof(int));
+  w.push_batch(values);
+  int failures = 0;
+  for (;;) {
+    try {
+      w.flush();
+      break;
+    } catch (const std::system_error& e) {
+      assert(e.code() == std::errc::resource_unavailable_try_again);
+      ++failures;
+      drain();
+    }
+  }
+  drain();
+  assert(failures > 0);
+  assert(read == values);
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+constexpr bool test() {
+  vector();
+  user_sink();
+  move_only();
+  moved_from();
+  return true;
+}
+
+TEST_POINT("any_output_range") {
+  test();
+  static_assert(test());
+}
+
+TEST_POINT("any_output_range containers") { other_containers(); }
+
+TEST_POINT("fd_writer") {
+  file();
+  file_move_assignment();
+  file_error();
+  file_short_write();
+}
+
+}  // namespace
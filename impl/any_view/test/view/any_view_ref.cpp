@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[any_view_ref]")
+
+namespace {
+
+using AnyViewRef = std::ranges::any_view_ref<int>;
+using AnyView = std::ranges::any_view<int>;
+
+static_assert(std::is_trivially_copyable_v<AnyViewRef>);
+static_assert(sizeof(AnyViewRef) == 2 * sizeof(void*));
+static_assert(std::ranges::view<AnyViewRef>);
+static_assert(std::ranges::input_range<const AnyViewRef>);
+static_assert(std::ranges::borrowed_range<AnyViewRef>);
+static_assert(std::same_as<std::ranges::iterator_t<AnyViewRef>,
+                           std::ranges::iterator_t<AnyView>>);
+
+static_assert(std::constructible_from<AnyViewRef, std::vector<int>&>);
+static_assert(!std::constructible_from<AnyViewRef, std::vector<int>>,
+              "a temporary would dangle");
+static_assert(!std::constructible_from<AnyViewRef, std::vector<long>&>);
+static_assert(
+    !std::constructible_from<
+        std::ranges::any_view_ref<int, std::ranges::any_view_options::forward>,
+        InputView&>);
+
+using SizedRef = std::ranges::any_view_ref<
+    int, std::ranges::any_view_options::random_access |
+             std::ranges::any_view_options::sized>;
+static_assert(std::ranges::random_access_range<SizedRef>);
+static_assert(std::ranges::sized_range<SizedRef>);
+
+// the any_view_ref and the referenced range are not constant-evaluable
+// because of the cast from void*, so these tests only run at runtime
+
+int sum(AnyViewRef v) {
+  int result = 0;
+  for (int i : v) {
+    result += i;
+  }
+  return result;
+}
+
+TEST_POINT("basic") {
+  std::vector v{1, 2, 3, 4, 5};
+  assert(sum(v) == 15);
+
+  std::array a{1, 2, 3};
+  assert(sum(a) == 6);
+
+  auto transformed = v | std::views::transform([](int& i) -> int& {
+                       return i;
+                     });
+  assert(sum(transformed) == 15);
+
+  AnyViewRef ref(v);
+  for (int& i : ref) {
+    i *= 2;
+  }
+  assert((v == std::vector{2, 4, 6, 8, 10}));
+}
+
+TEST_POINT("sized") {
+  std::vector v{5, 3, 1};
+  SizedRef ref(v);
+  assert(ref.size() == 3);
+  assert(ref[1] == 3);
+  std::ranges::sort(ref);
+  assert((v == std::vector{1, 3, 5}));
+}
+
+TEST_POINT("const") {
+  const std::vector v{1, 2, 3};
+  std::ranges::any_view_ref<const int> ref(v);
+  int result = 0;
+  for (int i : ref) {
+    result += i;
+  }
+  assert(result == 6);
+}
+
+TEST_POINT("from_any_view") {
+  std::vector v{1, 2, 3};
+  AnyView av(std::views::all(v));
+  assert(sum(av) == 6);
+
+  // the iterators of the any_view are not wrapped again
+  AnyViewRef ref(av);
+  assert(ref.begin().iter_.get_vtable() == av.begin().iter_.get_vtable());
+}
+
+TEST_POINT("copy") {
+  std::vector v{1, 2, 3};
+  AnyViewRef ref1(v);
+  AnyViewRef ref2 = ref1;
+  assert(sum(ref2) == 6);
+  ref1 = AnyViewRef{};
+  assert(sum(ref1) == 0);
+  assert(sum(ref2) == 6);
+}
+
+TEST_POINT("empty") {
+  AnyViewRef ref;
+  assert(ref.begin() == ref.end());
+  SizedRef sized;
+  assert(sized.size() == 0);
+}
+
+}  // namespace
@@ -0,0 +1,169 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <deque>
+#include <list>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[bulk_copy]")
+
+namespace {
+
+using AnyView = std::ranges::any_view<int>;
+using StringView = std::ranges::any_view<std::string>;
+
+static_assert(std::constructible_from<std::vector<int>, AnyView&>);
+static_assert(!std::convertible_to<AnyView&, std::vector<int>>);
+static_assert(!std::constructible_from<std::vector<long>, AnyView&>);
+
+template <class V>
+concept has_bulk_copy = requires(V& v, std::vector<std::string>& c) {
+  v.append_to(c);
+};
+
+static_assert(has_bulk_copy<StringView>);
+static_assert(!has_bulk_copy<std::ranges::any_view<std::unique_ptr<int>>>);
+
+constexpr void vector() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  std::vector<int> vec{0};
+  v.append_to(vec);
+  assert((vec == std::vector{0, 1, 2, 3, 4, 5}));
+
+  std::vector<int> converted(v);
+  assert((converted == std::vector{1, 2, 3, 4, 5}));
+
+  // not an array: the copy loop runs in the erased type
+  AnyView filtered(a | std::views::filter([](int i) { return i % 2 == 1; }));
+  std::vector<int> odd(filtered);
+  assert((odd == std::vector{1, 3, 5}));
+}
+
+constexpr void copy_to() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  std::array<int, 3> small{};
+  assert(v.copy_to(small) == 3);
+  assert((small == std::array{1, 2, 3}));
+
+  std::array<int, 8> large{};
+  assert(v.copy_to(large) == 5);
+  assert(large[4] == 5);
+  assert(large[5] == 0);
+
+  std::ranges::any_view<int, std::ranges::any_view_options::input, int> t(
+      a | std::views::transform([](int i) { return i * 10; }));
+  assert(t.copy_to(small) == 3);
+  assert((small == std::array{10, 20, 30}));
+
+  AnyView empty;
+  assert(empty.copy_to(small) == 0);
+}
+
+void other_containers() {
+  std::list<std::string> l{"a", "b", "c"};
+  StringView v(std::views::all(l));
+
+  std::deque<std::string> d{"z"};
+  v.append_to(d);
+  assert((d == std::deque<std::string>{"z", "a", "b", "c"}));
+
+  std::list<std::string> copy;
+  v.append_to(copy);
+  assert(copy == l);
+
+  std::vector<std::string> vec(v);
+  assert((vec == std::vector<std::string>{"a", "b", "c"}));
+}
+
+// an rvalue container is erased as an owning_view, which is move-only
+void owning() {
+  StringView v(std::vector<std::string>{"a", "b", "c"});
+  std::vector<std::string> out{"z"};
+  v.append_to(out);
+  assert((out == std::vector<std::string>{"z", "a", "b", "c"}));
+}
+
+// appending many times keeps the geometric growth
+void growth() {
+  std::vector<std::string> strings{"a"};
+  StringView v(std::views::all(strings));
+  std::vector<std::string> out;
+  size_t reallocations = 0;
+  for (int i = 0; i != 100; ++i) {
+    auto cap = out.capacity();
+    v.append_to(out);
+    reallocations += out.capacity() != cap;
+  }
+  assert(out.size() == 100);
+  assert(reallocations < 10);
+}
+
+// the element type can be incomplete where the any_view is declared, as in
+// a tree whose nodes refer to their children
+struct Node {
+  int value;
+  std::ranges::any_view<Node, std::ranges::any_view_options::forward> kids;
+};
+
+struct CopyableNode {
+  int value;
+  std::ranges::any_view<CopyableNode,
+                        std::ranges::any_view_options::forward |
+                            std::ranges::any_view_options::copyable>
+      kids;
+};
+
+static_assert(!has_bulk_copy<decltype(Node::kids)>);
+
+void recursive() {
+  std::vector<Node> leaves;
+  leaves.push_back(Node{2, {}});
+  leaves.push_back(Node{3, {}});
+  Node root{1, std::views::all(leaves)};
+  int sum = 0;
+  for (Node& n : root.kids) {
+    sum += n.value;
+  }
+  assert(sum == 5);
+
+  std::vector<CopyableNode> copyable_leaves{{4, {}}, {5, {}}};
+  CopyableNode copyable_root{1, std::views::all(copyable_leaves)};
+  std::vector<CopyableNode> kids(copyable_root.kids);
+  assert(kids.size() == 2);
+  assert(kids[1].value == 5);
+  std::deque<CopyableNode> d;
+  copyable_root.kids.append_to(d);
+  assert(d.size() == 2);
+  assert(d[0].value == 4);
+}
+
+constexpr bool test() {
+  vector();
+  copy_to();
+  return true;
+}
+
+TEST_POINT("bulk_copy") {
+  test();
+  static_assert(test());
+}
+
+TEST_POINT("bulk_copy containers") {
+  other_containers();
+  owning();
+  growth();
+  recursive();
+}
+
+}  // namespace
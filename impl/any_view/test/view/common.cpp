@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[common]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                   std::ranges::any_view_options::sized |
+                                   std::ranges::any_view_options::copyable |
+                                   std::ranges::any_view_options::common>;
+using Iter = std::ranges::iterator_t<AnyView>;
+
+static_assert(std::same_as<Iter, AnyView::any_iterator>);
+static_assert(std::same_as<std::ranges::sentinel_t<AnyView>, Iter>);
+static_assert(std::ranges::common_range<AnyView>);
+static_assert(std::ranges::random_access_range<AnyView>);
+static_assert(std::ranges::view<AnyView>);
+
+using ForwardView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                   std::ranges::any_view_options::common>;
+static_assert(std::ranges::common_range<ForwardView>);
+static_assert(std::ranges::forward_range<ForwardView>);
+
+// the underlying view has to be common
+static_assert(std::constructible_from<ForwardView, std::list<int>&>);
+static_assert(!std::constructible_from<
+              ForwardView, decltype(std::views::iota(0))>);
+static_assert(!std::constructible_from<
+              ForwardView,
+              decltype(std::views::counted(std::list<int>::iterator(), 3))>);
+
+// a view that counts the calls to end()
+struct CountingView : std::ranges::view_base {
+  std::array<int, 5>* a_ = nullptr;
+  int* ends_ = nullptr;
+
+  constexpr int* begin() const { return a_->data(); }
+  constexpr int* end() const {
+    ++*ends_;
+    return a_->data() + a_->size();
+  }
+};
+
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  assert(v.end() - v.begin() == 5);
+  assert(std::accumulate(v.begin(), v.end(), 0) == 15);
+
+  std::vector<int> copy(v.begin(), v.end());
+  assert(copy.size() == 5);
+  assert(copy[4] == 5);
+
+  std::reverse(v.begin(), v.end());
+  assert(a[0] == 5);
+}
+
+void list() {
+  std::list<int> l{1, 2, 3};
+  ForwardView v(l);
+  int sum = 0;
+  for (auto it = v.begin(); it != v.end(); ++it) {
+    sum += *it;
+  }
+  assert(sum == 6);
+}
+
+// end() is computed by the first call only
+constexpr void cached_end() {
+  std::array a{1, 2, 3, 4, 5};
+  int ends = 0;
+  AnyView v(CountingView{{}, &a, &ends});
+
+  auto last = v.end();
+  assert(ends == 1);
+  assert(v.end() == last);
+  assert(std::accumulate(v.begin(), v.end(), 0) == 15);
+  assert(ends == 1);
+
+  // a copy computes its own end
+  AnyView v2 = v;
+  assert(ends == 1);
+  assert(v2.end() - v2.begin() == 5);
+  assert(ends == 2);
+
+  AnyView v3 = std::move(v);
+  assert(v.begin() == v.end());
+  assert(v3.end() - v3.begin() == 5);
+  assert(ends == 3);
+
+  v3.swap(v);
+  assert(v3.begin() == v3.end());
+  assert(v.end() - v.begin() == 5);
+  assert(ends == 4);
+}
+
+constexpr void empty() {
+  AnyView v;
+  assert(v.begin() == v.end());
+  assert(v.empty());
+}
+
+constexpr void conversion() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  // a common any_view is handed over to a common any_view
+  ForwardView f(v);
+  assert(f.begin().target<int*>() != nullptr);
+  assert(f.end().target<int*>() != nullptr);
+  assert(std::ranges::distance(f) == 5);
+
+  // and to one that is not common, whose sentinel is the end iterator
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> g(v);
+  assert(g.begin().target<int*>() != nullptr);
+  assert(std::ranges::distance(g) == 5);
+  assert(std::ranges::next(g.begin(), 5) == g.end());
+  assert(g.begin() != g.end());
+
+  std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                 std::ranges::any_view_options::sized_sentinel>
+      s(v);
+  assert(s.begin().target<int*>() != nullptr);
+  assert(s.end() - s.begin() == 5);
+  assert(s.begin() - s.end() == -5);
+
+  AnyView empty;
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> e(empty);
+  assert(e.begin() == e.end());
+
+  // the elements are handed out in batches up to the end iterator
+  std::ranges::any_view<int, std::ranges::any_view_options::forward> moved(
+      AnyView(std::views::all(a)));
+  std::array<int*, 3> batch{};
+  auto it = moved.begin();
+  assert(it.next_batch(batch, moved.end()) == 3);
+  assert(*batch[2] == 3);
+  assert(it.next_batch(batch, moved.end()) == 2);
+  assert(*batch[1] == 5);
+  assert(it == moved.end());
+  assert(it.next_batch(batch, moved.end()) == 0);
+}
+
+constexpr bool test() {
+  basic();
+  cached_end();
+  empty();
+  conversion();
+  return true;
+}
+
+TEST_POINT("common") {
+  test();
+  static_assert(test());
+}
+
+TEST_POINT("common list") { list(); }
+
+}  // namespace
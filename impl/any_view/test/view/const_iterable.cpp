@@ -0,0 +1,115 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[const_iterable]")
+
+namespace {
+
+using AnyView = std::ranges::any_view<
+    int, std::ranges::any_view_options::forward |
+             std::ranges::any_view_options::const_iterable>;
+using NonConstView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+
+static_assert(std::ranges::forward_range<AnyView>);
+static_assert(std::ranges::forward_range<const AnyView>);
+static_assert(std::same_as<std::ranges::iterator_t<const AnyView>,
+                           std::ranges::iterator_t<AnyView>>);
+static_assert(!std::ranges::range<const NonConstView>);
+
+// filter_view caches begin(), so it is not const-iterable
+using FilterView = decltype(std::declval<std::vector<int>&>() |
+                            std::views::filter([](int) { return true; }));
+static_assert(std::constructible_from<NonConstView, FilterView>);
+static_assert(!std::constructible_from<AnyView, FilterView>);
+
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  const AnyView v(std::views::all(a));
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 15);
+  assert(!v.empty());
+  assert(v.front() == 1);
+}
+
+constexpr void transformed() {
+  std::array a{1, 2, 3};
+  const std::ranges::any_view<int,
+                              std::ranges::any_view_options::forward |
+                                  std::ranges::any_view_options::sized |
+                                  std::ranges::any_view_options::counted |
+                                  std::ranges::any_view_options::const_iterable,
+                              int>
+      v(a | std::views::transform([](int i) { return i * 10; }));
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 60);
+}
+
+constexpr void contiguous() {
+  std::array a{1, 2, 3};
+  const std::ranges::any_view<
+      int, std::ranges::any_view_options::contiguous |
+               std::ranges::any_view_options::const_iterable>
+      v(std::views::all(a));
+  assert(v.begin() == a.data());
+  assert(v.end() == a.data() + 3);
+}
+
+constexpr void empty() {
+  const AnyView v;
+  assert(v.begin() == v.end());
+}
+
+constexpr bool test() {
+  basic();
+  transformed();
+  contiguous();
+  empty();
+  return true;
+}
+
+TEST_POINT("const_iterable") {
+  test();
+  static_assert(test());
+}
+
+TEST_POINT("const_iterable_threads") {
+  std::vector<int> data(10000);
+  std::iota(data.begin(), data.end(), 0);
+  const AnyView v(data);
+
+  std::vector<long> sums(8);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t != sums.size(); ++t) {
+    threads.emplace_back([&v, &sums, t] {
+      long sum = 0;
+      for (int i : v) {
+        sum += i;
+      }
+      sums[t] = sum;
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  for (long sum : sums) {
+    assert(sum == 9999L * 10000L / 2);
+  }
+}
+
+}  // namespace
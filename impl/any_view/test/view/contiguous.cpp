@@ -3,6 +3,7 @@
 #include <array>
 #include <cassert>
 #include <catch2/catch_test_macros.hpp>
+#include <span>
 
 #include "../helper.hpp"
 #include "any_view.hpp"
@@ -17,8 +18,9 @@ using AnyView =
 static_assert(std::ranges::contiguous_range<AnyView>);
 static_assert(std::movable<AnyView>);
 static_assert(!std::copyable<AnyView>);
-static_assert(!std::ranges::sized_range<AnyView>);
-static_assert(!std::ranges::common_range<AnyView>);
+// iterator and sentinel are pointers
+static_assert(std::ranges::sized_range<AnyView>);
+static_assert(std::ranges::common_range<AnyView>);
 static_assert(!std::ranges::borrowed_range<AnyView>);
 
 using AnyViewFull =
@@ -31,7 +33,7 @@ static_assert(std::ranges::contiguous_range<AnyViewFull>);
 static_assert(std::movable<AnyViewFull>);
 static_assert(std::copyable<AnyViewFull>);
 static_assert(std::ranges::sized_range<AnyViewFull>);
-static_assert(!std::ranges::common_range<AnyViewFull>);
+static_assert(std::ranges::common_range<AnyViewFull>);
 static_assert(std::ranges::borrowed_range<AnyViewFull>);
 
 static_assert(!std::is_constructible_v<AnyView, InputView>);
@@ -105,7 +107,34 @@ constexpr void contiguous() {
   std::array v{1, 2, 3, 4, 5};
   V view(std::views::all(v));
   std::same_as<int*> decltype(auto) it1 = view.begin();
-  assert(it1 == v[0]);
+  assert(it1 == &v[0]);
+
+  std::same_as<int*> decltype(auto) st = view.end();
+  assert(st == v.data() + v.size());
+}
+
+struct Base {
+  int i;
+};
+
+struct Derived : Base {
+  int j;
+};
+
+static_assert(
+    !std::is_constructible_v<std::ranges::any_view<
+                                 Base, std::ranges::any_view_options::contiguous>,
+                             std::span<Derived>>,
+    "pointer arithmetic on Base* would be wrong");
+static_assert(
+    std::is_constructible_v<std::ranges::any_view<
+                                const int, std::ranges::any_view_options::contiguous>,
+                            std::span<int>>);
+
+constexpr void empty() {
+  AnyView view;
+  assert(view.begin() == view.end());
+  assert(view.data() == nullptr);
 }
 
 template <class V>
@@ -159,6 +188,9 @@ constexpr bool test() {
   bidirectional<AnyViewFull>();
   random_access<AnyView>();
   random_access<AnyViewFull>();
+  contiguous<AnyView>();
+  contiguous<AnyViewFull>();
+  empty();
   move<AnyView>();
   move<AnyViewFull>();
   copy<AnyViewFull>();
@@ -3,11 +3,15 @@
 #include <cassert>
 #include <catch2/catch_test_macros.hpp>
 #include <concepts>
+#include <cstddef>
+#include <deque>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "../helper.hpp"
 #include "any_view.hpp"
+#include "any_view_instrumentation.hpp"
 
 #define TEST_POINT(x) TEST_CASE(x, "[conversion]")
 namespace {
@@ -56,14 +60,119 @@ static_assert(!std::is_constructible_v<std::ranges::any_view<const int>,
                                        std::ranges::iota_view<int, int>>,
               "range of prvalue is not convertible to range of const ref");
 
-    constexpr bool test() {
+// an any_view converted to another any_view with the same reference types
+// adopts the erased iterator of the source, instead of erasing it again
+constexpr void test_flatten() {
+  int a[] = {1, 2, 3, 4, 5};
+  using Source =
+      std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                     std::ranges::any_view_options::sized |
+                                     std::ranges::any_view_options::copyable>;
+  using Target =
+      std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+  Source src(a);
+  Target v(src);
+
+  assert(v.begin().iter_.get_vtable() == src.begin().iter_.get_vtable());
+  assert(v.end().sent_vtable_ == src.end().sent_vtable_);
+
+  auto it = v.begin();
+  auto it2 = it;
+  ++it;
+  assert(*it == 2);
+  assert(*it2 == 1);
+  assert(std::ranges::equal(v, a));
+
+  // and so does a view converted twice
+  std::ranges::any_view<int> in(std::move(v));
+  assert(in.begin().iter_.get_vtable() == src.begin().iter_.get_vtable());
+  int sum = 0;
+  for (int i : in) {
+    sum += i;
+  }
+  assert(sum == 15);
+}
+
+// only used here, so that its counters start at 0
+struct FlattenIter {
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  int* p = nullptr;
+
+  int& operator*() const { return *p; }
+  FlattenIter& operator++() {
+    ++p;
+    return *this;
+  }
+  FlattenIter operator++(int) {
+    auto tmp = *this;
+    ++p;
+    return tmp;
+  }
+  friend bool operator==(const FlattenIter&, const FlattenIter&) = default;
+};
+
+struct CountedPolicy : std::ranges::any_view_policy {
+  using instrumentation = std::ranges::any_view_instrumentation;
+};
+
+// the loops of a converted view run inside the view it was converted from,
+// without a call through its erased iterator per element
+void test_flatten_loops() {
+  using std::ranges::any_view_event;
+  using std::ranges::any_view_instrumentation;
+  using Source = std::ranges::any_view<
+      int,
+      std::ranges::any_view_options::forward |
+          std::ranges::any_view_options::copyable,
+      int&, int&&, std::ptrdiff_t, CountedPolicy>;
+  using Target =
+      std::ranges::any_view<int, std::ranges::any_view_options::forward, int&,
+                            int&&, std::ptrdiff_t, CountedPolicy>;
+
+  int a[] = {3, 1, 5, 2, 4};
+  Source src(std::ranges::subrange(FlattenIter{a}, FlattenIter{a + 5}));
+  Target v(src);
+
+  int sum = 0;
+  v.for_each([&](int i) { sum += i; });
+  assert(sum == 15);
+  assert(v.count(2) == 1);
+  assert(v.accumulate(0) == 15);
+  auto found = v.find(5);
+  auto min = v.min_element();
+  auto max = v.max_element();
+  std::vector<int> vec;
+  v.append_to(vec);
+  std::deque<int> d;
+  v.append_to(d);
+  std::array<int, 5> out{};
+  assert(v.copy_to(out) == 5);
+
+  for (auto e : {any_view_event::deref, any_view_event::increment,
+                 any_view_event::equal}) {
+    assert(any_view_instrumentation::count<FlattenIter>(e) == 0);
+  }
+
+  assert(*found == 5);
+  assert(*min == 1);
+  assert(*max == 5);
+  assert((vec == std::vector{3, 1, 5, 2, 4}));
+  assert((d == std::deque{3, 1, 5, 2, 4}));
+  assert((out == std::array{3, 1, 5, 2, 4}));
+}
+
+constexpr bool test() {
   test_ref_conv();
+  test_flatten();
   return true;
 }
 
 TEST_POINT("conversion") {
   test();
   static_assert(test());
+  test_flatten_loops();
 }
 
 }  // namespace
@@ -0,0 +1,94 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[counted]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward |
+                                   std::ranges::any_view_options::sized |
+                                   std::ranges::any_view_options::counted>;
+using Iter = std::ranges::iterator_t<AnyView>;
+
+static_assert(std::same_as<Iter, std::counted_iterator<AnyView::any_iterator>>);
+static_assert(
+    std::same_as<std::ranges::sentinel_t<AnyView>, std::default_sentinel_t>);
+static_assert(std::ranges::forward_range<AnyView>);
+static_assert(std::ranges::sized_range<AnyView>);
+static_assert(std::ranges::view<AnyView>);
+static_assert(std::sized_sentinel_for<std::default_sentinel_t, Iter>);
+
+using RandomAccessView = std::ranges::any_view<
+    int, std::ranges::any_view_options::random_access |
+             std::ranges::any_view_options::sized |
+             std::ranges::any_view_options::counted>;
+static_assert(std::ranges::random_access_range<RandomAccessView>);
+
+using InputAnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::input |
+                                   std::ranges::any_view_options::sized |
+                                   std::ranges::any_view_options::counted>;
+static_assert(std::ranges::input_range<InputAnyView>);
+static_assert(!std::ranges::forward_range<InputAnyView>);
+
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(std::views::all(a));
+
+  auto it = v.begin();
+  assert(it.count() == 5);
+  assert(std::ranges::distance(it, v.end()) == 5);
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 15);
+}
+
+constexpr void random_access() {
+  std::array a{1, 2, 3, 4, 5};
+  RandomAccessView v(std::views::all(a));
+  auto it = v.begin() + 3;
+  assert(*it == 4);
+  assert(it.count() == 2);
+  assert(v[1] == 2);
+}
+
+constexpr void input() {
+  int a[] = {1, 2, 3};
+  InputAnyView v(std::ranges::subrange(
+      test_iter<int*, std::input_iterator_tag>{a},
+      test_iter<int*, std::input_iterator_tag>{a + 3}, 3));
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 6);
+}
+
+constexpr void empty() {
+  AnyView v;
+  assert(v.begin() == v.end());
+  assert(v.size() == 0);
+}
+
+constexpr bool test() {
+  basic();
+  random_access();
+  input();
+  empty();
+  return true;
+}
+
+TEST_POINT("counted") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
@@ -0,0 +1,93 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[cursor]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::input>;
+
+template <class T>
+concept has_cursor = requires(T& t) { t.cursor(); };
+
+static_assert(has_cursor<AnyView>);
+static_assert(has_cursor<std::ranges::any_view<
+                  int, std::ranges::any_view_options::random_access>>);
+static_assert(!has_cursor<std::ranges::any_view<
+                  int, std::ranges::any_view_options::input, int>>);
+
+constexpr void basic() {
+  std::array v{1, 2, 3};
+  AnyView view(std::views::all(v));
+
+  auto c = view.cursor();
+  {
+    std::same_as<int*> decltype(auto) p = c.next();
+    assert(p == &v[0]);
+  }
+  assert(c.next() == &v[1]);
+  assert(c.next() == &v[2]);
+  assert(c.next() == nullptr);
+}
+
+constexpr void loop() {
+  int a[] = {1, 2, 3, 4, 5};
+  AnyView view(InputView{a});
+
+  int sum = 0;
+  auto c = view.cursor();
+  while (auto* p = c.next()) {
+    sum += *p;
+  }
+  assert(sum == 15);
+}
+
+constexpr void move() {
+  std::array v{1, 2, 3};
+  AnyView view(std::views::all(v));
+
+  auto c1 = view.cursor();
+  assert(*c1.next() == 1);
+
+  auto c2 = std::move(c1);
+  assert(*c2.next() == 2);
+}
+
+constexpr void filter() {
+  std::array<std::string, 4> v{"a", "bb", "ccc", "dddd"};
+  std::ranges::any_view<std::string> view(
+      v | std::views::filter([](auto& s) { return s.size() % 2 == 0; }));
+
+  auto c = view.cursor();
+  assert(c.next() == &v[1]);
+  assert(c.next() == &v[3]);
+  assert(c.next() == nullptr);
+}
+
+constexpr void empty() {
+  AnyView view;
+  auto c = view.cursor();
+  assert(c.next() == nullptr);
+}
+
+constexpr bool test() {
+  basic();
+  loop();
+  move();
+  filter();
+  empty();
+  return true;
+}
+
+TEST_POINT("cursor") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
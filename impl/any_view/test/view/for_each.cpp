@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[for_each]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::input>;
+
+struct Sum {
+  int sum = 0;
+  int count = 0;
+  constexpr void operator()(int i) {
+    sum += i;
+    ++count;
+  }
+};
+
+constexpr void basic() {
+  std::array v{1, 2, 3, 4, 5};
+  AnyView view(std::views::all(v));
+
+  std::same_as<Sum> decltype(auto) r = view.for_each(Sum{});
+  assert(r.sum == 15);
+  assert(r.count == 5);
+}
+
+constexpr void mutate() {
+  std::array v{1, 2, 3, 4, 5};
+  AnyView view(std::views::all(v));
+
+  view.for_each([](int& i) { i *= 2; });
+  assert((v == std::array{2, 4, 6, 8, 10}));
+}
+
+constexpr void prvalue() {
+  std::array v{1, 2, 3, 4, 5};
+  std::ranges::any_view<int, std::ranges::any_view_options::forward, int> view(
+      v | std::views::transform([](int i) { return i * 10; }));
+
+  auto r = view.for_each(Sum{});
+  assert(r.sum == 150);
+}
+
+constexpr void input_only() {
+  int a[] = {1, 2, 3};
+  AnyView view(InputView{a});
+
+  auto r = view.for_each(Sum{});
+  assert(r.sum == 6);
+  assert(r.count == 3);
+}
+
+constexpr void empty() {
+  AnyView view;
+  auto r = view.for_each(Sum{});
+  assert(r.count == 0);
+}
+
+constexpr void expected() {
+  std::array v{1, 2, 3, 4, 5};
+  using Ref = std::ranges::ref_view<std::array<int, 5>>;
+  using Transform =
+      decltype(std::views::all(v) | std::views::transform(std::negate<>{}));
+  AnyView view(std::views::all(v));
+
+  // matching
+  auto r1 = view.for_each<Ref>(Sum{});
+  assert(r1.sum == 15);
+
+  // not matching, falls back to the erased loop
+  auto r2 = view.for_each<std::ranges::subrange<int*>>(Sum{});
+  assert(r2.sum == 15);
+
+  // several candidates
+  std::ranges::any_view<int, std::ranges::any_view_options::input, int>
+      transformed(std::views::all(v) | std::views::transform(std::negate<>{}));
+  auto r3 = transformed.for_each<Ref, Transform>(Sum{});
+  assert(r3.sum == -15);
+  auto r4 = transformed.for_each<Ref>(Sum{});
+  assert(r4.sum == -15);
+
+  // mutation through the inlined loop
+  view.for_each<Ref>([](int& i) { i *= 2; });
+  assert((v == std::array{2, 4, 6, 8, 10}));
+
+  AnyView empty;
+  assert(empty.for_each<Ref>(Sum{}).count == 0);
+}
+
+constexpr bool test() {
+  basic();
+  mutate();
+  prvalue();
+  input_only();
+  empty();
+  expected();
+  return true;
+}
+
+TEST_POINT("for_each") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[indexed]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                   std::ranges::any_view_options::sized |
+                                   std::ranges::any_view_options::indexed>;
+using Iter = std::ranges::iterator_t<AnyView>;
+
+static_assert(std::ranges::random_access_range<AnyView>);
+static_assert(!std::ranges::contiguous_range<AnyView>);
+static_assert(std::ranges::sized_range<AnyView>);
+static_assert(std::ranges::common_range<AnyView>);
+static_assert(!std::ranges::borrowed_range<AnyView>);
+static_assert(std::ranges::view<AnyView>);
+static_assert(std::is_trivially_copyable_v<Iter>);
+static_assert(sizeof(Iter) == 3 * sizeof(void*));
+static_assert(std::same_as<std::iter_reference_t<Iter>, int&>);
+static_assert(std::same_as<std::iter_rvalue_reference_t<Iter>, int&&>);
+
+constexpr void basic() {
+  std::array a{5, 3, 1, 4, 2};
+  AnyView v(std::views::all(a));
+  assert(v.size() == 5);
+
+  auto it = v.begin();
+  assert(*it == 5);
+  assert(it[2] == 1);
+  assert(*(it + 3) == 4);
+  assert(*(3 + it) == 4);
+  assert(v.end() - it == 5);
+  assert(it < v.end());
+  assert(it + 5 == v.end());
+
+  ++it;
+  assert(*it == 3);
+  it += 2;
+  assert(*it == 4);
+  --it;
+  assert(*it == 1);
+  it -= 1;
+  assert(*it == 3);
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 15);
+}
+
+constexpr void algorithms() {
+  std::array a{5, 3, 1, 4, 2};
+  AnyView v(std::views::all(a));
+
+  std::ranges::sort(v);
+  assert((a == std::array{1, 2, 3, 4, 5}));
+
+  auto it = std::ranges::lower_bound(v, 3);
+  assert(it - v.begin() == 2);
+
+  std::ranges::nth_element(v, v.begin() + 1, std::ranges::greater{});
+  assert(a[1] == 4);
+}
+
+constexpr void transformed() {
+  std::array a{1, 2, 3};
+  std::ranges::any_view<int,
+                        std::ranges::any_view_options::random_access |
+                            std::ranges::any_view_options::sized |
+                            std::ranges::any_view_options::indexed,
+                        int>
+      v(a | std::views::transform([](int i) { return i * 10; }));
+  assert(v[1] == 20);
+  assert(std::ranges::iter_move(v.begin() + 2) == 30);
+}
+
+constexpr void move_only_elements() {
+  std::vector<MoveOnly> vec;
+  vec.emplace_back(1);
+  vec.emplace_back(2);
+  std::ranges::any_view<MoveOnly,
+                        std::ranges::any_view_options::random_access |
+                            std::ranges::any_view_options::sized |
+                            std::ranges::any_view_options::indexed>
+      v(vec);
+  MoveOnly m = std::ranges::iter_move(v.begin() + 1);
+  assert(m.i == 2);
+}
+
+constexpr void empty() {
+  AnyView v;
+  assert(v.size() == 0);
+  assert(v.begin() == v.end());
+  assert(std::ranges::empty(v));
+}
+
+constexpr bool test() {
+  basic();
+  algorithms();
+  transformed();
+  move_only_elements();
+  empty();
+  return true;
+}
+
+TEST_POINT("indexed") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
@@ -0,0 +1,239 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+#include "any_view_instrumentation.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[instrumentation]")
+
+namespace {
+
+using std::ranges::any_view_event;
+using std::ranges::any_view_instrumentation;
+
+struct CountedPolicy : std::ranges::any_view_policy {
+  using instrumentation = any_view_instrumentation;
+};
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward, int&,
+                          int&&, std::ptrdiff_t, CountedPolicy>;
+
+// the types are only used here, so that their counters start at 0
+template <std::size_t N>
+struct PaddedIter {
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  int* p = nullptr;
+  std::array<char, N> state{};
+
+  constexpr int& operator*() const { return *p; }
+  constexpr PaddedIter& operator++() {
+    ++p;
+    return *this;
+  }
+  constexpr PaddedIter operator++(int) {
+    auto tmp = *this;
+    ++p;
+    return tmp;
+  }
+  friend constexpr bool operator==(const PaddedIter& x, const PaddedIter& y) {
+    return x.p == y.p;
+  }
+};
+
+using Iter = PaddedIter<1>;
+using View = std::ranges::subrange<Iter>;
+using BigIter = PaddedIter<64>;
+using BigView = std::ranges::subrange<BigIter>;
+
+static_assert(!std::ranges::any_view_policy::instrumentation::enabled);
+
+// nothing is recorded during constant evaluation
+constexpr bool constant() {
+  std::array a{1, 2, 3};
+  AnyView v(View(Iter{a.data()}, Iter{a.data() + a.size()}));
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  return sum == 6;
+}
+static_assert(constant());
+
+void counts() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(View(Iter{a.data()}, Iter{a.data() + a.size()}));
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 15);
+
+  assert(any_view_instrumentation::count<View>(any_view_event::begin) == 1);
+  assert(any_view_instrumentation::count<View>(any_view_event::end) == 1);
+  assert(any_view_instrumentation::count<Iter>(any_view_event::deref) == 5);
+  assert(any_view_instrumentation::count<Iter>(any_view_event::increment) ==
+         5);
+  assert(any_view_instrumentation::count<Iter>(any_view_event::equal) == 6);
+  assert(any_view_instrumentation::count<Iter>(
+             any_view_event::heap_allocation) == 0);
+
+  auto it = v.begin();
+  auto copy = it;
+  assert(*copy == 1);
+  assert(any_view_instrumentation::count<Iter>(any_view_event::copy) == 1);
+}
+
+void heap_and_threads() {
+  std::array a{1, 2, 3};
+  AnyView v(BigView(BigIter{a.data()}, BigIter{a.data() + a.size()}));
+
+  auto run = [&] {
+    auto last = v.end();
+    for (auto it = v.begin(); it != last; ++it) {
+    }
+  };
+  std::thread t1(run);
+  std::thread t2(run);
+  t1.join();
+  t2.join();
+
+  // the iterator and the sentinel, on each thread
+  assert(any_view_instrumentation::count<BigIter>(
+             any_view_event::heap_allocation) == 4);
+  assert(any_view_instrumentation::count<BigIter>(
+             any_view_event::increment) == 6);
+
+  std::ostringstream os;
+  any_view_instrumentation::dump_json(os);
+  std::string json = os.str();
+  assert(json.starts_with("{\"types\": [{"));
+  assert(json.ends_with("}]}"));
+  assert(json.find("\"heap_allocation\": 4") != std::string::npos);
+}
+
+// iter_move and distance_to are counted too
+void random_access() {
+  std::vector<int> vec{1, 2, 3};
+  std::ranges::any_view<int, std::ranges::any_view_options::random_access,
+                        int&, int&&, std::ptrdiff_t, CountedPolicy>
+      v(std::views::all(vec));
+  using It = std::vector<int>::iterator;
+
+  int i = std::ranges::iter_move(v.begin());
+  assert(i == 1);
+  assert(std::ranges::next(v.begin(), 2) - v.begin() == 2);
+  assert(any_view_instrumentation::count<It>(any_view_event::iter_move) == 1);
+  assert(any_view_instrumentation::count<It>(any_view_event::distance_to) ==
+         1);
+}
+
+// a thread takes over the counters of an exited thread, and they keep
+// their counts
+void exited_threads() {
+  std::array a{1, 2, 3, 4};
+  using Iter2 = PaddedIter<2>;
+  AnyView v(std::ranges::subrange<Iter2>(Iter2{a.data()},
+                                         Iter2{a.data() + a.size()}));
+  auto run = [&] {
+    for (auto it = v.begin(); it != v.end(); ++it) {
+    }
+  };
+  for (int i = 0; i != 3; ++i) {
+    std::thread(run).join();
+  }
+  assert(any_view_instrumentation::count<Iter2>(any_view_event::increment) ==
+         12);
+}
+
+// a thread_local destroyed after the counters were given back does not
+// write to them
+using Iter3 = PaddedIter<3>;
+
+struct LateIteration {
+  AnyView* v_;
+  ~LateIteration() {
+    for (auto it = v_->begin(); it != v_->end(); ++it) {
+    }
+  }
+};
+
+void thread_exit() {
+  std::array a{1, 2, 3};
+  AnyView v(std::ranges::subrange<Iter3>(Iter3{a.data()},
+                                         Iter3{a.data() + a.size()}));
+  std::thread([&] {
+    // constructed before the counters are claimed, so destroyed after they
+    // are given back
+    thread_local LateIteration late{&v};
+    for (auto it = v.begin(); it != v.end(); ++it) {
+    }
+  }).join();
+  assert(any_view_instrumentation::count<Iter3>(any_view_event::increment) ==
+         3);
+}
+
+// a scope marks a call site: the same type is counted per site
+using Iter4 = PaddedIter<4>;
+
+void sites() {
+  std::array a{1, 2, 3};
+  AnyView v(std::ranges::subrange<Iter4>(Iter4{a.data()},
+                                         Iter4{a.data() + a.size()}));
+  auto run = [&] {
+    for (auto it = v.begin(); it != v.end(); ++it) {
+    }
+  };
+
+  std::source_location first = std::source_location::current();
+  std::source_location second = std::source_location::current();
+  {
+    any_view_instrumentation::scope s(first);
+    run();
+    {
+      any_view_instrumentation::scope inner(second);
+      run();
+      run();
+    }
+    run();
+  }
+  run();
+
+  assert(any_view_instrumentation::count<Iter4>(any_view_event::increment,
+                                                first) == 6);
+  assert(any_view_instrumentation::count<Iter4>(any_view_event::increment,
+                                                second) == 6);
+  assert(any_view_instrumentation::count<Iter4>(any_view_event::increment,
+                                                std::source_location()) == 3);
+  assert(any_view_instrumentation::count<Iter4>(any_view_event::increment) ==
+         15);
+
+  std::ostringstream os;
+  any_view_instrumentation::dump_json(os);
+  std::string site = std::string(second.file_name()) + ':' +
+                     std::to_string(second.line()) + ':' +
+                     std::to_string(second.column());
+  assert(os.str().find("\"site\": \"" + site + '"') != std::string::npos);
+}
+
+TEST_POINT("instrumentation") {
+  counts();
+  heap_and_threads();
+  random_access();
+  exited_threads();
+  thread_exit();
+  sites();
+}
+
+}  // namespace
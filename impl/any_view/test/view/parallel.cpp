@@ -0,0 +1,159 @@
+#include <atomic>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+#include "parallel.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[parallel]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::random_access |
+                                   std::ranges::any_view_options::sized>;
+
+static_assert(std::same_as<decltype(std::declval<AnyView&>().slice(0, 1)),
+                           AnyView>);
+
+template <class V>
+concept can_split = requires(V& v) { v.split(2); };
+static_assert(can_split<AnyView>);
+static_assert(!can_split<std::ranges::any_view<int>>);
+static_assert(
+    !can_split<std::ranges::any_view<
+        int, std::ranges::any_view_options::random_access>>);
+
+constexpr void slice() {
+  std::vector v{1, 2, 3, 4, 5};
+  AnyView av(v);
+
+  AnyView s = av.slice(1, 4);
+  assert(s.size() == 3);
+  assert(std::ranges::equal(s, std::vector{2, 3, 4}));
+  assert(av.slice(2, 2).empty());
+
+  AnyView empty;
+  assert(empty.slice(0, 0).empty());
+}
+
+constexpr void split() {
+  std::vector<int> v(10);
+  std::iota(v.begin(), v.end(), 0);
+  AnyView av(v);
+
+  auto parts = av.split(3);
+  assert(parts.size() == 3);
+  assert(parts[0].size() == 3);
+  assert(parts[1].size() == 3);
+  assert(parts[2].size() == 4);
+  std::vector<int> joined;
+  for (auto& p : parts) {
+    for (int i : p) {
+      joined.push_back(i);
+    }
+  }
+  assert(joined == v);
+
+  // more parts than elements
+  std::vector<int> small{1, 2};
+  AnyView av2(small);
+  auto parts2 = av2.split(4);
+  assert(parts2.size() == 4);
+  size_t total = 0;
+  for (auto& p : parts2) {
+    total += p.size();
+  }
+  assert(total == 2);
+}
+
+constexpr bool test() {
+  slice();
+  split();
+  return true;
+}
+
+TEST_POINT("split") {
+  test();
+  static_assert(test());
+}
+
+struct Digits {
+  Digits() = default;
+  Digits(int d) : s(1, char('0' + d)) {}
+  std::string s;
+};
+
+Digits concat(Digits x, const Digits& y) {
+  x.s += y.s;
+  return x;
+}
+
+TEST_POINT("parallel") {
+  std::vector<int> v(10000);
+  std::iota(v.begin(), v.end(), 1);
+  AnyView av(v);
+
+  std::atomic<long> sum = 0;
+  std::ranges::parallel_for_each(
+      av, [&](int i) { sum.fetch_add(i, std::memory_order_relaxed); }, 4);
+  assert(sum == 50005000);
+
+  assert(std::ranges::parallel_reduce(av, 0L, std::plus{}, 4) == 50005000);
+  assert(std::ranges::parallel_reduce(av, 7L, std::plus{}, 1) == 50005007);
+
+  // in order: concatenation is associative but not commutative
+  std::vector<int> digits{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  AnyView dv(digits);
+  Digits r = std::ranges::parallel_reduce(dv, Digits(), concat, 3);
+  assert(r.s == "123456789");
+
+  AnyView empty;
+  assert(std::ranges::parallel_reduce(empty, 3, std::plus{}) == 3);
+}
+
+// the exception is rethrown on the calling thread, and the remaining parts
+// are not started
+TEST_POINT("parallel exception") {
+  std::vector<int> v(10000);
+  std::iota(v.begin(), v.end(), 0);
+  AnyView av(v);
+
+  std::atomic<int> calls = 0;
+  bool caught = false;
+  try {
+    std::ranges::parallel_for_each(
+        av,
+        [&](int i) {
+          calls.fetch_add(1, std::memory_order_relaxed);
+          if (i % 100 == 0) throw std::runtime_error("fn");
+        },
+        4);
+  } catch (const std::runtime_error& e) {
+    caught = std::string(e.what()) == "fn";
+  }
+  assert(caught);
+  assert(calls < 10000);
+
+  caught = false;
+  try {
+    std::ranges::parallel_reduce(
+        av, 0,
+        [](int x, int y) {
+          if (y == 5001) throw std::runtime_error("op");
+          return x + y;
+        },
+        4);
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  assert(caught);
+}
+
+}  // namespace
@@ -0,0 +1,93 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[policy]")
+
+namespace {
+
+struct BigBuffers : std::ranges::any_view_policy {
+  static constexpr size_t iterator_buffer_size = 8 * sizeof(void*);
+  static constexpr size_t view_buffer_size = 16 * sizeof(void*);
+  static constexpr size_t buffer_alignment = 32;
+};
+
+using DefaultView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+using BigView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward, int&,
+                          int&&, std::ptrdiff_t, BigBuffers>;
+
+// an iterator carrying a lot of state, over-aligned like a SIMD register
+struct alignas(32) FatIter {
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+
+  int* p = nullptr;
+  std::array<char, 32> state{};
+
+  constexpr int& operator*() const { return *p; }
+  constexpr FatIter& operator++() {
+    ++p;
+    return *this;
+  }
+  constexpr FatIter operator++(int) {
+    auto tmp = *this;
+    ++p;
+    return tmp;
+  }
+  friend constexpr bool operator==(const FatIter& x, const FatIter& y) {
+    return x.p == y.p;
+  }
+};
+static_assert(std::forward_iterator<FatIter>);
+
+using FatView = std::ranges::subrange<FatIter>;
+
+static_assert(!DefaultView::iterator_storage::unittest_is_small<FatIter>());
+static_assert(BigView::iterator_storage::unittest_is_small<FatIter>());
+static_assert(sizeof(std::ranges::iterator_t<BigView>) ==
+              8 * sizeof(void*) + 32);
+
+static_assert(!DefaultView::view_storage::unittest_is_small<FatView>());
+static_assert(BigView::view_storage::unittest_is_small<FatView>());
+
+static_assert(std::ranges::forward_range<BigView>);
+static_assert(std::ranges::view<BigView>);
+
+template <class V>
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  V v(FatView(FatIter{a.data()}, FatIter{a.data() + a.size()}));
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 15);
+
+  auto it1 = v.begin();
+  auto it2 = it1;
+  ++it2;
+  assert(*it1 == 1);
+  assert(*it2 == 2);
+  it1 = std::move(it2);
+  assert(*it1 == 2);
+}
+
+constexpr bool test() {
+  basic<DefaultView>();
+  basic<BigView>();
+  return true;
+}
+
+TEST_POINT("policy") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
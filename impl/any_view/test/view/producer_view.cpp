@@ -0,0 +1,120 @@
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+#include "producer_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[producer_view]")
+
+namespace {
+
+// counts to `last`, and records how the calls are batched
+struct Counter {
+  int last;
+  int* calls;
+  int i = 0;
+
+  constexpr std::optional<int> operator()() {
+    ++*calls;
+    if (i == last) return std::nullopt;
+    return i++;
+  }
+};
+
+using PV = std::ranges::producer_view<Counter, 4>;
+static_assert(std::ranges::input_range<PV>);
+static_assert(std::ranges::view<PV>);
+static_assert(!std::ranges::forward_range<PV>);
+static_assert(
+    std::same_as<std::ranges::sentinel_t<PV>, std::default_sentinel_t>);
+
+constexpr void basic() {
+  int calls = 0;
+  std::ranges::any_view<int> v(PV(Counter{10, &calls}));
+  auto it = v.begin();
+  // the first batch is read by begin()
+  assert(calls == 4);
+
+  std::vector<int> out;
+  for (; it != v.end(); ++it) {
+    out.push_back(*it);
+  }
+  assert((out == std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  // 3 batches, and the call that returned nullopt
+  assert(calls == 11);
+}
+
+constexpr void empty() {
+  int calls = 0;
+  std::ranges::any_view<int> v(PV(Counter{0, &calls}));
+  assert(v.begin() == v.end());
+  assert(calls == 1);
+}
+
+constexpr void capturing_lambda() {
+  std::string s = "abc";
+  size_t i = 0;
+  std::ranges::any_view<char> v(std::ranges::producer_view(
+      [&]() -> std::optional<char> {
+        if (i == s.size()) return std::nullopt;
+        return s[i++];
+      }));
+  std::string out;
+  for (char c : v) {
+    out += c;
+  }
+  assert(out == "abc");
+}
+
+constexpr void read_ahead() {
+  std::vector<std::string> words{"a", "b", "c", "d", "e"};
+  std::ranges::any_view<std::string> v(std::ranges::read_ahead<2>(words));
+  std::string out;
+  for (auto& w : v) {
+    out += w;
+  }
+  assert(out == "abcde");
+}
+
+#if __cpp_lib_generator >= 202207L
+std::generator<int> iota(int n) {
+  for (int i = 0; i != n; ++i) {
+    co_yield i;
+  }
+}
+
+void generator() {
+  std::ranges::any_view<int> v(std::ranges::read_ahead(iota(100)));
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 4950);
+}
+#else
+void generator() {}
+#endif
+
+constexpr bool test() {
+  basic();
+  empty();
+  capturing_lambda();
+  read_ahead();
+  return true;
+}
+
+TEST_POINT("producer_view") {
+  test();
+  static_assert(test());
+  generator();
+}
+
+}  // namespace
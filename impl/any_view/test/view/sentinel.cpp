@@ -0,0 +1,75 @@
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <iterator>
+#include <list>
+#include <ranges>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[sentinel]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward, int,
+                          int>;
+
+// unreachable_sentinel_t is not stored, and the comparison does not call
+// into the vtable
+constexpr void unreachable() {
+  AnyView v(std::views::iota(0));
+  auto it = v.begin();
+  auto last = v.end();
+  assert(last.sent_.is_singular());
+  assert(it != last);
+
+  int sum = 0;
+  for (int i : v) {
+    if (i == 5) break;
+    sum += i;
+  }
+  assert(sum == 10);
+
+  auto last2 = last;
+  last = std::move(last2);
+  assert(++it != last);
+}
+
+// default_sentinel_t is not stored either, the end is tested by the iterator
+void at_end() {
+  std::list<int> l{1, 2, 3, 4, 5};
+  AnyView v(std::views::counted(l.begin(), 3));
+  static_assert(std::same_as<std::ranges::sentinel_t<decltype(
+                                 std::views::counted(l.begin(), 3))>,
+                             std::default_sentinel_t>);
+  auto last = v.end();
+  assert(last.sent_.is_singular());
+
+  int sum = 0;
+  for (int i : v) {
+    sum += i;
+  }
+  assert(sum == 6);
+
+  auto it = v.begin();
+  ++it;
+  ++it;
+  assert(it != last);
+  ++it;
+  assert(it == last);
+}
+
+constexpr bool test() {
+  unreachable();
+  return true;
+}
+
+TEST_POINT("unreachable_sentinel") {
+  test();
+  static_assert(test());
+}
+
+TEST_POINT("default_sentinel") { at_end(); }
+
+}  // namespace
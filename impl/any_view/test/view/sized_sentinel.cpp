@@ -0,0 +1,84 @@
+#include <array>
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[sized_sentinel]")
+
+namespace {
+
+using AnyView = std::ranges::any_view<
+    int, std::ranges::any_view_options::forward |
+             std::ranges::any_view_options::sized_sentinel>;
+using Iter = std::ranges::iterator_t<AnyView>;
+using Sent = std::ranges::sentinel_t<AnyView>;
+
+using ForwardAnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+
+static_assert(std::sized_sentinel_for<Sent, Iter>);
+// view_interface::size is end() - begin()
+static_assert(std::ranges::sized_range<AnyView>);
+static_assert(!std::ranges::sized_range<ForwardAnyView>);
+static_assert(!std::sized_sentinel_for<std::ranges::sentinel_t<ForwardAnyView>,
+                                       std::ranges::iterator_t<ForwardAnyView>>);
+
+// a sentinel that is not the iterator, but knows the distance to it
+struct SizedSentinel {
+  int* end;
+
+  friend constexpr bool operator==(int* it, SizedSentinel s) {
+    return it == s.end;
+  }
+  friend constexpr std::ptrdiff_t operator-(SizedSentinel s, int* it) {
+    return s.end - it;
+  }
+  friend constexpr std::ptrdiff_t operator-(int* it, SizedSentinel s) {
+    return it - s.end;
+  }
+};
+
+using View = std::ranges::subrange<int*, SizedSentinel>;
+static_assert(!std::ranges::common_range<View>);
+static_assert(std::constructible_from<AnyView, View>);
+static_assert(!std::constructible_from<AnyView, ForwardView>);
+
+constexpr void basic() {
+  std::array a{1, 2, 3, 4, 5};
+  AnyView v(View(a.data(), SizedSentinel{a.data() + a.size()}));
+
+  auto it = v.begin();
+  auto last = v.end();
+  assert(last - it == 5);
+  assert(it - last == -5);
+  assert(std::ranges::distance(it, last) == 5);
+  assert(std::ranges::distance(v) == 5);
+
+  ++it;
+  assert(last - it == 4);
+
+  // bounded advance knows how far it can go without walking
+  assert(std::ranges::advance(it, 10, last) == 6);
+  assert(it == last);
+  assert(last - it == 0);
+}
+
+constexpr void empty() {
+  AnyView v;
+  assert(v.end() - v.begin() == 0);
+}
+
+constexpr bool test() {
+  basic();
+  empty();
+  return true;
+}
+
+TEST_POINT("sized_sentinel") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace
@@ -0,0 +1,64 @@
+#include <cassert>
+#include <catch2/catch_test_macros.hpp>
+#include <ranges>
+#include <vector>
+
+#include "../helper.hpp"
+#include "any_view.hpp"
+
+#define TEST_POINT(x) TEST_CASE(x, "[target]")
+
+namespace {
+
+using AnyView =
+    std::ranges::any_view<int, std::ranges::any_view_options::forward>;
+using RefView = std::ranges::ref_view<std::vector<int>>;
+
+constexpr void view_target() {
+  std::vector v{1, 2, 3};
+  AnyView av(v);
+
+  RefView* r = av.target<RefView>();
+  assert(r != nullptr);
+  assert(&r->base() == &v);
+  assert(av.target<std::ranges::owning_view<std::vector<int>>>() == nullptr);
+
+  const AnyView& cav = av;
+  std::same_as<const RefView*> decltype(auto) cr = cav.target<RefView>();
+  assert(cr == r);
+
+  AnyView empty;
+  assert(empty.target<RefView>() == nullptr);
+}
+
+constexpr void iterator_target() {
+  std::vector v{1, 2, 3};
+  AnyView av(v);
+  auto it = av.begin();
+  ++it;
+
+  using Iter = std::vector<int>::iterator;
+  Iter* i = it.target<Iter>();
+  assert(i != nullptr);
+  assert(*i == v.begin() + 1);
+  assert(it.target<int*>() == nullptr);
+
+  const auto& cit = it;
+  std::same_as<const Iter*> decltype(auto) ci = cit.target<Iter>();
+  assert(ci == i);
+
+  assert(decltype(it)().target<Iter>() == nullptr);
+}
+
+constexpr bool test() {
+  view_target();
+  iterator_target();
+  return true;
+}
+
+TEST_POINT("target") {
+  test();
+  static_assert(test());
+}
+
+}  // namespace